@@ -0,0 +1,84 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+/**
+ * @file alloc_counter.h
+ * @brief Heap allocation counter of the benchmarks
+ *
+ * Counts every heap allocation of the process in heap_allocations. All the
+ * replaceable allocation functions are replaced (array, nothrow and aligned
+ * forms too), so each new form is released by the matching delete.
+ * Replacements cannot be inline: include this header from exactly one
+ * translation unit of a binary (its benchmark's main file).
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> heap_allocations{0};
+
+static void *counted_alloc(size_t size, size_t align) {
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (size == 0) size = 1;
+  if (align <= alignof(std::max_align_t)) return std::malloc(size);
+  return std::aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+static void *counted_new(size_t size, size_t align) {
+  if (void *p = counted_alloc(size, align)) return p;
+  throw std::bad_alloc();
+}
+
+void *operator new(size_t size) { return counted_new(size, 0); }
+void *operator new[](size_t size) { return counted_new(size, 0); }
+void *operator new(size_t size, std::align_val_t align) {
+  return counted_new(size, static_cast<size_t>(align));
+}
+void *operator new[](size_t size, std::align_val_t align) {
+  return counted_new(size, static_cast<size_t>(align));
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return counted_alloc(size, 0);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return counted_alloc(size, 0);
+}
+void *operator new(size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+  return counted_alloc(size, static_cast<size_t>(align));
+}
+void *operator new[](size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+  return counted_alloc(size, static_cast<size_t>(align));
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void *p, size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+void operator delete(void *p, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+void operator delete[](void *p, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  std::free(p);
+}
+
+#endif  // ALLOC_COUNTER_H
@@ -0,0 +1,34 @@
+# Simulator engine and model sources shared by the benchmark targets
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+
+INCLUDEPATH += $$PWD/..
+
+SOURCES += \
+    $$PWD/../core/Simulator.cpp \
+    $$PWD/../core/EventQueue.cpp \
+    $$PWD/../core/EventType.cpp \
+    $$PWD/../core/CalendarQueue.cpp \
+    $$PWD/../core/RadixQueue.cpp \
+    $$PWD/../core/TimingWheel.cpp \
+    $$PWD/../core/Snapshot.cpp \
+    $$PWD/../core/EngineStats.cpp \
+    $$PWD/../core/Tracer.cpp \
+    $$PWD/../core/ParallelSimulator.cpp \
+    $$PWD/../core/SimContext.cpp \
+    $$PWD/../core/Config.cpp \
+    $$PWD/../events/TaskGenerationEvent.cpp \
+    $$PWD/../events/SpecifiedTasksEvent.cpp \
+    $$PWD/../model/CPU.cpp \
+    $$PWD/../model/EventHandlers.cpp \
+    $$PWD/../model/FirstRemotePolicy.cpp \
+    $$PWD/../model/IntelligentPolicy.cpp \
+    $$PWD/../model/Model.cpp \
+    $$PWD/../model/OffPolicy.cpp \
+    $$PWD/../model/RandomPolicy.cpp \
+    $$PWD/../model/Task.cpp \
+    $$PWD/../model/Vehicle.cpp \
+
+HEADERS += \
+    $$PWD/alloc_counter.h
@@ -0,0 +1,112 @@
+/**
+ * @file dispatch_benchmark.cpp
+ * @brief Per-event overhead of Simulator::run: legacy vs compact dispatch
+ *
+ * The legacy path is reproduced here as it existed before the compact
+ * records: one Event subclass per event, a virtual execute()
+ * and a lookup in a per-model unordered_map of std::function closures.
+ * The compact path schedules (time, model, EventType) records dispatched
+ * through the static event_handlers table.
+ *
+ * Both paths target OnProcessingStart on an idle model with an empty queue,
+ * which returns immediately, so the measurement is queue + dispatch cost.
+ *
+ * Usage:
+ *   ./dispatch_benchmark [events]
+ */
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/Simulator.h"
+#include "model/Model.h"
+
+using std::cout, std::endl;
+
+namespace {
+
+struct LegacyModel {
+  using Map = std::unordered_map<EventType, std::function<void(Simulator &)>>;
+  Model model;
+  Map events;
+  LegacyModel() {
+    events[EventType::OnProcessingStart] = [this](Simulator &sim) {
+      model.OnProcessingStart(sim);
+    };
+  }
+};
+
+class LegacyEvent : public Event {
+  std::shared_ptr<LegacyModel> model;
+  EventType type;
+
+ public:
+  LegacyEvent(double t, std::shared_ptr<LegacyModel> model_, EventType type_)
+      : Event(t), model(std::move(model_)), type(type_) {}
+  void execute(Simulator &sim) override { model->events[type](sim); }
+};
+
+std::vector<double> make_times(size_t n) {
+  std::mt19937 engine{1978};
+  std::uniform_real_distribution<double> d(0.0, 1000.0);
+  std::vector<double> times(n);
+  for (auto &t : times) t = d(engine);
+  return times;
+}
+
+template <typename Fn>
+double time_ns_per_event(size_t n, Fn &&fill) {
+  Simulator sim;
+  fill(sim);
+  auto t0 = std::chrono::steady_clock::now();
+  sim.run(1e9);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t events = 1000000;
+  if (argc > 1) events = std::stoul(argv[1]);
+  const size_t models = 64;
+  auto times = make_times(events);
+
+  std::vector<std::shared_ptr<LegacyModel>> legacy;
+  std::vector<std::unique_ptr<Model>> compact;
+  for (size_t i = 0; i < models; ++i) {
+    legacy.push_back(std::make_shared<LegacyModel>());
+    compact.push_back(std::make_unique<Model>());
+  }
+
+  double legacy_ns = time_ns_per_event(events, [&](Simulator &sim) {
+    for (size_t i = 0; i < events; ++i) {
+      sim.schedule<LegacyEvent>(times[i], legacy[i % models],
+                                EventType::OnProcessingStart);
+    }
+  });
+  double compact_ns = time_ns_per_event(events, [&](Simulator &sim) {
+    for (size_t i = 0; i < events; ++i) {
+      sim.schedule(times[i], *compact[i % models],
+                   EventType::OnProcessingStart);
+    }
+  });
+
+  cout << "Dispatch benchmark (" << events << " events, " << models
+       << " models)" << endl;
+  cout << std::fixed << std::setprecision(1);
+  cout << "  legacy  (virtual + map + std::function): " << legacy_ns
+       << " ns/event" << endl;
+  cout << "  compact (EventType jump table):          " << compact_ns
+       << " ns/event" << endl;
+  cout << "  speedup: " << std::setprecision(2) << legacy_ns / compact_ns
+       << "x" << endl;
+  return 0;
+}
@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = dispatch_benchmark
+
+include(bench.pri)
+
+SOURCES += dispatch_benchmark.cpp
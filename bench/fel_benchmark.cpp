@@ -0,0 +1,112 @@
+/**
+ * @file fel_benchmark.cpp
+ * @brief Events/sec of the future event list backends (classic hold model)
+ *
+ * A population of N pending events is kept constant: every executed event
+ * schedules one successor at now + Exp(1). This is the standard FEL
+ * benchmark and approximates many vehicles each with one pending arrival.
+ * Heap allocations during run() are counted by alloc_counter.h.
+ * The radix heap is also run on a nanosecond integer clock, and the heap
+ * with the Simulator's timing wheel in front of it (off in the other rows).
+ *
+ * Usage:
+ *   ./fel_benchmark [events_per_point]
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "core/Simulator.h"
+
+using std::cout, std::endl;
+
+namespace {
+
+std::mt19937 bench_engine{1978};
+
+class HoldEvent : public Event {
+ public:
+  explicit HoldEvent(double t) : Event(t) {}
+  void execute(Simulator &sim) override {
+    static thread_local std::exponential_distribution<double> gap(1.0);
+    sim.schedule<HoldEvent>(sim.now() + gap(bench_engine));
+  }
+};
+
+struct Point {
+  double events_per_sec;
+  double ns_per_event;
+  double allocs_per_event;
+  size_t peak_events;
+};
+
+struct Backend {
+  QueueKind kind;
+  double resolution;  // 0: continuous time
+  double wheel;       // timing wheel granularity, 0: none
+};
+
+Point run_hold(Backend backend, size_t population, size_t events) {
+  bench_engine.seed(1978);
+  std::exponential_distribution<double> gap(1.0);
+  Simulator sim(backend.kind);
+  sim.set_resolution(backend.resolution);
+  sim.set_wheel_granularity(backend.wheel);
+  for (size_t i = 0; i < population; ++i) {
+    sim.schedule<HoldEvent>(gap(bench_engine));
+  }
+  // Population N with unit mean gaps advances ~N events per time unit
+  double horizon = static_cast<double>(events) / population;
+
+  size_t allocs_before = heap_allocations.load();
+  auto t0 = std::chrono::steady_clock::now();
+  sim.run(horizon);
+  auto t1 = std::chrono::steady_clock::now();
+  size_t allocs = heap_allocations.load() - allocs_before;
+
+  double secs = std::chrono::duration<double>(t1 - t0).count();
+  return {events / secs, secs * 1e9 / events,
+          static_cast<double>(allocs) / events, sim.event_stats().peak};
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t events = 2000000;
+  if (argc > 1) events = std::stoul(argv[1]);
+
+  const std::vector<size_t> populations = {10, 1000, 100000, 1000000};
+  const std::vector<Backend> backends = {
+      {QueueKind::BinaryHeap, 0.0, 0.0}, {QueueKind::Calendar, 0.0, 0.0},
+      {QueueKind::Radix, 0.0, 0.0},      {QueueKind::Radix, 1e-9, 0.0},
+      {QueueKind::BinaryHeap, 0.0, micro_step}};
+
+  cout << "FEL hold benchmark (" << events << " events per point)" << endl;
+  cout << std::left << std::setw(12) << "Queue" << std::right << std::setw(12)
+       << "Pending" << std::setw(16) << "Events/s" << std::setw(12)
+       << "ns/event" << std::setw(14) << "allocs/event" << std::setw(12)
+       << "peak live" << endl;
+  cout << std::string(78, '-') << endl;
+
+  for (size_t n : populations) {
+    for (const Backend &b : backends) {
+      Point p = run_hold(b, n, events);
+      std::string name = queue_kind_name(b.kind);
+      if (b.resolution > 0.0) name += "/ns";
+      if (b.wheel > 0.0) name += "+wheel";
+      cout << std::left << std::setw(12) << name << std::right
+           << std::setw(12) << n << std::setw(16) << std::fixed
+           << std::setprecision(0) << p.events_per_sec << std::setw(12)
+           << std::setprecision(1) << p.ns_per_event << std::setw(14)
+           << std::setprecision(4) << p.allocs_per_event << std::setw(12)
+           << p.peak_events << endl;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = fel_benchmark
+
+include(bench.pri)
+
+SOURCES += fel_benchmark.cpp
@@ -0,0 +1,482 @@
+/**
+ * @file hotpath_benchmark.cpp
+ * @brief ns/op, allocations/op and throughput of the simulator hot paths
+ *
+ * Each case times one operation in isolation on the inputs the simulation
+ * feeds it: scheduling and dispatching events, generating tasks from the
+ * workload, recording metrics, writing them as CSV or columns, summarizing
+ * them in the run, trace logging
+ * and the offloading policies' decide(). Setup stays outside the timed
+ * region. The iteration count is calibrated to --min-time per run and the
+ * median of five runs is reported; heap allocations are counted by
+ * alloc_counter.h.
+ *
+ * --json=FILE writes the results as JSON, one case per line; --baseline=FILE
+ * reads such a file back and flags cases slower than it by more than
+ * --tolerance (exit status 2), so a stored baseline can gate a change.
+ *
+ * Usage:
+ *   ./hotpath_benchmark [--filter=TEXT] [--min-time=0.1] [--json=FILE]
+ *                       [--baseline=FILE] [--tolerance=0.10]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "core/Config.h"
+#include "core/SimContext.h"
+#include "core/Simulator.h"
+#include "logger.h"
+#include "metric.h"
+#include "metric_columns.h"
+#include "metric_stats.h"
+#include "model/FirstRemotePolicy.h"
+#include "model/IntelligentPolicy.h"
+#include "model/MetricNames.h"
+#include "model/OffPolicy.h"
+#include "model/RSU.h"
+#include "model/RandomPolicy.h"
+#include "model/Task.h"
+#include "model/Vehicle.h"
+#include "utils/Workload.h"
+
+using std::cout, std::endl;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Timed region of one run; the case brackets its loop with start()/stop()
+class Meter {
+ public:
+  void start() {
+    allocs = heap_allocations.load(std::memory_order_relaxed);
+    t0 = Clock::now();
+  }
+  void stop() {
+    seconds += std::chrono::duration<double>(Clock::now() - t0).count();
+    allocations +=
+        heap_allocations.load(std::memory_order_relaxed) - allocs;
+  }
+
+  double seconds = 0.0;
+  size_t allocations = 0;
+
+ private:
+  Clock::time_point t0;
+  size_t allocs = 0;
+};
+
+struct Case {
+  std::string name;
+  // Performs n operations, timing them with the meter
+  std::function<void(size_t n, Meter &meter)> body;
+};
+
+struct Result {
+  std::string name;
+  size_t iterations;
+  double ns_per_op;
+  double allocs_per_op;
+  double ops_per_sec;
+};
+
+class NopEvent : public Event {
+ public:
+  explicit NopEvent(double t) : Event(t) {}
+  void execute(Simulator &) override {}
+};
+
+// One successor per event at now + micro_step * k, k in 1..64: the
+// task-hop pattern of the model
+class HopEvent : public Event {
+ public:
+  explicit HopEvent(double t) : Event(t) {}
+  void execute(Simulator &sim) override {
+    static thread_local uint32_t k = 0;
+    k = k * 1664525u + 1013904223u;
+    sim.schedule<HopEvent>(sim.now() + micro_step * (1 + (k >> 26)));
+  }
+};
+
+class NullListener : public IMetricListener {
+ public:
+  void onMetricRecorded(const MetricRecord &) override {}
+};
+
+// A remote TaskLatency record as Model::OnProcessingComplete reports it
+MetricRecord sample_record() {
+  return {12.345678,
+          0.0421,
+          42,
+          3,
+          metrics::TaskLatency,
+          metric_tags::Remote,
+          MetricRegistry::location("model/Model.cpp", 120)};
+}
+
+std::string scratch(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// Vehicle with four RSUs and a block of generated tasks, as decide() sees
+// them during a run
+void decide_case(size_t n, Meter &meter, OffPolicy::PtrOffPolicy policy) {
+  SimContext context(1978);
+  SimContext::Scope scope(&context);
+  Simulator sim;
+  std::vector<RSU::PtrRSU> rsus;
+  for (int i = 0; i < 4; ++i) rsus.push_back(std::make_shared<RSU>());
+  auto vehicle = std::make_shared<Vehicle>(policy);
+  vehicle->set_rsus(rsus);
+  std::vector<Task> tasks;
+  for (size_t i = 0; i < 1024; ++i) {
+    tasks.emplace_back(sim, Workload::instance().next());
+  }
+  size_t remote = 0;
+  meter.start();
+  for (size_t i = 0; i < n; ++i) {
+    DecisionResult r = policy->decide(tasks[i & 1023], rsus);
+    remote += r.decision_type == DecisionType::Remote;
+  }
+  meter.stop();
+  if (remote > n) std::abort();  // keeps the loop
+}
+
+std::vector<Case> cases() {
+  std::vector<Case> all;
+
+  all.push_back({"Simulator::schedule/custom", [](size_t n, Meter &meter) {
+                   Simulator sim;
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     sim.schedule<NopEvent>(1.0 + (i & 1023) * micro_step);
+                   }
+                   meter.stop();
+                 }});
+  all.push_back({"Simulator::schedule/model", [](size_t n, Meter &meter) {
+                   SimContext context(1978);
+                   SimContext::Scope scope(&context);
+                   Simulator sim;
+                   auto rsu = std::make_shared<RSU>();
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     sim.schedule(1.0 + (i & 1023) * micro_step, *rsu,
+                                  EventType::OnProcessingComplete);
+                   }
+                   meter.stop();
+                 }});
+  all.push_back({"Simulator::run/hop 1k pending", [](size_t n, Meter &meter) {
+                   Simulator sim;
+                   for (size_t i = 0; i < 1000; ++i) {
+                     sim.schedule<HopEvent>(i * micro_step);
+                   }
+                   sim.run(0.1);  // warm the pool and the wheel
+                   uint64_t before = sim.events_executed();
+                   // 1000 pending with mean gap 32.5 micro_steps
+                   double horizon = sim.now() + n * 32.5 * micro_step / 1000;
+                   meter.start();
+                   sim.run(horizon);
+                   meter.stop();
+                   // Normalize to the events actually dispatched
+                   double done = sim.events_executed() - before;
+                   meter.seconds *= n / std::max(done, 1.0);
+                 }});
+  all.push_back({"Task::Task/workload", [](size_t n, Meter &meter) {
+                   SimContext context(1978);
+                   SimContext::Scope scope(&context);
+                   Simulator sim;
+                   int64_t sink = 0;
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     Task task(sim, Workload::instance().next());
+                     sink += task.get_data_size();
+                   }
+                   meter.stop();
+                   if (sink < 0) std::abort();
+                 }});
+  all.push_back({"Task::Task/workload chaos", [](size_t n, Meter &meter) {
+                   Config::Parameters config = Config::defaults();
+                   config.FIELD_TOTAL_CHAOS = true;
+                   SimContext context(1978, config);
+                   SimContext::Scope scope(&context);
+                   Simulator sim;
+                   int64_t sink = 0;
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     Task task(sim, Workload::instance().next());
+                     sink += task.get_data_size();
+                   }
+                   meter.stop();
+                   if (sink < 0) std::abort();
+                 }});
+  all.push_back({"MetricsHub::record/1 listener", [](size_t n, Meter &meter) {
+                   MetricsHub hub;
+                   hub.addListener(std::make_shared<NullListener>());
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     hub.record(i * 1e-3, 1, metrics::TaskLatency, 0.25,
+                                metric_tags::Local, static_cast<int>(i),
+                                MetricRegistry::location(__FILE__, __LINE__));
+                   }
+                   meter.stop();
+                 }});
+  all.push_back({"MetricsHub::record/partition buffer",
+                 [](size_t n, Meter &meter) {
+                   MetricsHub hub;
+                   std::vector<MetricRecord> buffer;
+                   buffer.reserve(4096);
+                   std::vector<MetricRecord> *previous =
+                       MetricsHub::bind_buffer(&buffer);
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     hub.record(i * 1e-3, 1, metrics::TaskLatency, 0.25,
+                                metric_tags::Local, static_cast<int>(i),
+                                MetricRegistry::location(__FILE__, __LINE__));
+                     if (buffer.size() == 4096) buffer.clear();
+                   }
+                   meter.stop();
+                   MetricsHub::bind_buffer(previous);
+                 }});
+  all.push_back({"CSVMetricsCollector::flush/record",
+                 [](size_t n, Meter &meter) {
+                   std::string path = scratch("hotpath_benchmark.csv");
+                   {
+                     CSVMetricsCollector csv(path);
+                     MetricRecord rec = sample_record();
+                     // Batches of the collector's buffer size
+                     for (size_t done = 0; done < n;) {
+                       size_t batch = std::min<size_t>(n - done, 9999);
+                       for (size_t i = 0; i < batch; ++i) {
+                         csv.onMetricRecorded(rec);
+                       }
+                       meter.start();
+                       csv.flush();
+                       meter.stop();
+                       done += batch;
+                     }
+                   }
+                   std::filesystem::remove(path);
+                 }});
+  all.push_back({"ColumnarMetricsCollector/record+flush",
+                 [](size_t n, Meter &meter) {
+                   std::string path = scratch("hotpath_benchmark.mcol");
+                   {
+                     ColumnarMetricsCollector columns(path);
+                     MetricRecord rec = sample_record();
+                     meter.start();
+                     for (size_t i = 0; i < n; ++i) {
+                       columns.onMetricRecorded(rec);
+                     }
+                     columns.flush();
+                     meter.stop();
+                   }
+                   std::filesystem::remove(path);
+                 }});
+  all.push_back({"MetricStatistics::onMetricRecorded",
+                 [](size_t n, Meter &meter) {
+                   MetricStatistics statistics;
+                   MetricRecord rec = sample_record();
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     rec.time = i * 1e-3;
+                     rec.value = 0.01 + (i % 1000) * 1e-3;
+                     statistics.onMetricRecorded(rec);
+                   }
+                   meter.stop();
+                 }});
+  all.push_back({"Logger::log/trace on", [](size_t n, Meter &meter) {
+                   std::string path = scratch("hotpath_benchmark.log");
+                   {
+                     Logger logger(path);
+                     meter.start();
+                     for (size_t i = 0; i < n; ++i) {
+                       logger.log(i * 1e-3, LogLevel::INFO,
+                                  "Task {} | Node {} | PROCESSING_START | "
+                                  "queue_size={}",
+                                  42, 4, i & 7);
+                     }
+                     logger.flush();  // until written: sustained rate
+                     meter.stop();
+                   }
+                   std::filesystem::remove(path);
+                 }});
+  all.push_back({"Logger::log/trace on, string", [](size_t n, Meter &meter) {
+                   std::string path = scratch("hotpath_benchmark.log");
+                   {
+                     Logger logger(path);
+                     std::string msg = "Task 42 offloaded to RSU 4";
+                     meter.start();
+                     for (size_t i = 0; i < n; ++i) {
+                       logger.log(i * 1e-3, LogLevel::INFO, msg);
+                     }
+                     logger.flush();
+                     meter.stop();
+                   }
+                   std::filesystem::remove(path);
+                 }});
+  all.push_back({"Logger::log/trace off", [](size_t n, Meter &meter) {
+                   Logger logger("");
+                   meter.start();
+                   for (size_t i = 0; i < n; ++i) {
+                     logger.log(i * 1e-3, LogLevel::INFO,
+                                "Task {} | Node {} | PROCESSING_START | "
+                                "queue_size={}",
+                                42, 4, i & 7);
+                   }
+                   meter.stop();
+                 }});
+  all.push_back({"OffPolicy::decide/Local", [](size_t n, Meter &meter) {
+                   decide_case(n, meter, std::make_shared<OffPolicy>());
+                 }});
+  all.push_back({"OffPolicy::decide/Random", [](size_t n, Meter &meter) {
+                   decide_case(n, meter, std::make_shared<RandomPolicy>());
+                 }});
+  all.push_back({"OffPolicy::decide/FirstRemote", [](size_t n, Meter &meter) {
+                   decide_case(n, meter,
+                               std::make_shared<FirstRemotePolicy>());
+                 }});
+  all.push_back({"OffPolicy::decide/Intelligent", [](size_t n, Meter &meter) {
+                   decide_case(n, meter,
+                               std::make_shared<IntelligentPolicy>());
+                 }});
+  return all;
+}
+
+Result measure(const Case &c, double min_time) {
+  // Grow n until one run takes a tenth of min_time, then size runs to it
+  size_t n = 64;
+  for (;;) {
+    Meter meter;
+    c.body(n, meter);
+    if (meter.seconds >= min_time / 10 || n >= (size_t(1) << 30)) {
+      double per_op = std::max(meter.seconds, 1e-9) / n;
+      n = std::max<size_t>(n, static_cast<size_t>(min_time / per_op));
+      break;
+    }
+    n *= 8;
+  }
+  std::vector<double> seconds;
+  size_t allocations = 0;
+  for (int run = 0; run < 5; ++run) {
+    Meter meter;
+    c.body(n, meter);
+    seconds.push_back(meter.seconds);
+    allocations += meter.allocations;
+  }
+  std::sort(seconds.begin(), seconds.end());
+  double per_op = seconds[2] / n;
+  return {c.name, n, per_op * 1e9, static_cast<double>(allocations) / (5 * n),
+          1.0 / per_op};
+}
+
+void write_json(const std::string &path, const std::vector<Result> &results) {
+  std::ofstream out(path);
+  out << std::setprecision(6) << "{\"benchmark\": \"hotpath\", \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    out << (i ? ",\n" : "\n") << "  {\"name\": \"" << r.name
+        << "\", \"iterations\": " << r.iterations
+        << ", \"ns_per_op\": " << r.ns_per_op
+        << ", \"allocs_per_op\": " << r.allocs_per_op
+        << ", \"ops_per_sec\": " << r.ops_per_sec << "}";
+  }
+  out << "\n]}\n";
+}
+
+// ns/op by case name from a file written by write_json()
+std::map<std::string, double> read_baseline(const std::string &path) {
+  std::ifstream in(path);
+  if (!in) throw std::runtime_error("cannot read baseline " + path);
+  const std::regex entry(
+      "\"name\": \"([^\"]*)\".*\"ns_per_op\": ([-+.0-9eE]+)");
+  std::map<std::string, double> baseline;
+  std::string line;
+  std::smatch m;
+  while (std::getline(in, line)) {
+    if (std::regex_search(line, m, entry)) {
+      baseline[m[1]] = std::stod(m[2]);
+    }
+  }
+  return baseline;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::string filter, json_file, baseline_file;
+  double min_time = 0.1;
+  double tolerance = 0.10;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&](const char *flag) { return arg.substr(strlen(flag)); };
+    if (arg.rfind("--filter=", 0) == 0) {
+      filter = value("--filter=");
+    } else if (arg.rfind("--min-time=", 0) == 0) {
+      min_time = std::stod(value("--min-time="));
+    } else if (arg.rfind("--json=", 0) == 0) {
+      json_file = value("--json=");
+    } else if (arg.rfind("--baseline=", 0) == 0) {
+      baseline_file = value("--baseline=");
+    } else if (arg.rfind("--tolerance=", 0) == 0) {
+      tolerance = std::stod(value("--tolerance="));
+    } else {
+      std::cerr << "Unknown option '" << arg << "'" << endl;
+      return 1;
+    }
+  }
+  std::map<std::string, double> baseline;
+  if (!baseline_file.empty()) baseline = read_baseline(baseline_file);
+
+  cout << "Hot path benchmark (median of 5 runs of ~" << min_time << " s)"
+       << endl;
+  cout << std::left << std::setw(38) << "Case" << std::right << std::setw(12)
+       << "ns/op" << std::setw(14) << "allocs/op" << std::setw(14) << "ops/s";
+  if (!baseline.empty()) cout << std::setw(12) << "vs base";
+  cout << endl;
+  cout << std::string(baseline.empty() ? 78 : 90, '-') << endl;
+
+  std::vector<Result> results;
+  int regressions = 0;
+  for (const Case &c : cases()) {
+    if (c.name.find(filter) == std::string::npos) continue;
+    Result r = measure(c, min_time);
+    results.push_back(r);
+    cout << std::left << std::setw(38) << r.name << std::right << std::fixed
+         << std::setw(12) << std::setprecision(1) << r.ns_per_op
+         << std::setw(14) << std::setprecision(3) << r.allocs_per_op
+         << std::setw(14) << std::setprecision(0) << r.ops_per_sec;
+    auto base = baseline.find(r.name);
+    if (base != baseline.end()) {
+      double change = r.ns_per_op / base->second - 1.0;
+      bool slower = change > tolerance;
+      regressions += slower;
+      cout << std::setw(10) << std::setprecision(1) << std::showpos
+           << 100.0 * change << std::noshowpos << "%" << (slower ? " !" : "");
+    }
+    cout << endl;
+  }
+
+  if (!json_file.empty()) {
+    write_json(json_file, results);
+    cout << "Results written to " << json_file << endl;
+  }
+  if (regressions > 0) {
+    cout << regressions << " case(s) slower than the baseline by more than "
+         << 100.0 * tolerance << "%" << endl;
+    return 2;
+  }
+  return 0;
+}
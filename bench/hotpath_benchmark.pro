@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = hotpath_benchmark
+
+include(bench.pri)
+
+SOURCES += hotpath_benchmark.cpp
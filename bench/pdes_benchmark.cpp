@@ -0,0 +1,242 @@
+/**
+ * @file pdes_benchmark.cpp
+ * @brief Strong scaling of the ParallelSimulator, 1..N threads
+ *
+ * Builds V vehicles and R RSUs, vehicle v reaching RSUs v mod R and
+ * v+1 mod R (RandomPolicy), and runs it once on a plain Simulator (the
+ * reference) and then on a ParallelSimulator with 1 and P partitions for
+ * every thread count (and synchronization mode). RSU r and the vehicles of
+ * its cell go to partition r mod P, so part of the traffic crosses
+ * partitions through the uplink latency lookahead. The metric records are
+ * hashed to check that every run produces the records of the reference;
+ * the hash ignores their order, which may differ at equal timestamps.
+ *
+ * The default model hands tasks over synchronously (UPLINK_LATENCY = 0)
+ * and cannot be partitioned; uplink=SECONDS runs every engine, the
+ * reference included, on a model with that latency.
+ *
+ * Usage:
+ *   ./pdes_benchmark [vehicles] [rsus] [partitions] [duration] [max_threads]
+ *                    [conservative|optimistic|both] [chaos] [uplink=SECONDS]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/ChaosManager.h"
+#include "core/Config.h"
+#include "core/ParallelSimulator.h"
+#include "events/TaskGenerationEvent.h"
+#include "logger.h"
+#include "metric.h"
+#include "model/RSU.h"
+#include "model/RandomPolicy.h"
+#include "model/Vehicle.h"
+#include "utils/Rng.h"
+
+using std::cout, std::endl;
+
+namespace {
+
+// Sum of the FNV-1a hashes of every record's fields: the same for the same
+// records in any order
+class ChecksumListener : public IMetricListener {
+ public:
+  uint64_t hash = 0;
+  uint64_t records = 0;
+
+  static void mix(uint64_t &h, const void *data, size_t n) {
+    const auto *p = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < n; ++i) {
+      h ^= p[i];
+      h *= 1099511628211ull;
+    }
+  }
+
+  void onMetricRecorded(const MetricRecord &rec) override {
+    uint64_t h = 1469598103934665603ull;
+    mix(h, &rec.time, sizeof(rec.time));
+    mix(h, &rec.entity_id, sizeof(rec.entity_id));
+    mix(h, rec.metric_name().data(), rec.metric_name().size());
+    mix(h, &rec.value, sizeof(rec.value));
+    mix(h, rec.tag_name().data(), rec.tag_name().size());
+    mix(h, &rec.task_id, sizeof(rec.task_id));
+    hash += h;
+    ++records;
+  }
+};
+
+struct Result {
+  double wall;
+  uint64_t events;
+  uint64_t windows;
+  uint64_t messages;
+  uint64_t rolled_back;
+  uint64_t hash;
+  uint64_t records;
+};
+
+// partitions == 0 runs the reference on a plain Simulator
+Result run_once(size_t vehicles, size_t rsus, size_t partitions,
+                double duration, size_t threads, SyncMode mode) {
+  // Same starting state for every run
+  Rng::streams().seed(1978);
+  ChaosManager::instance().reset();
+  ChaosManager::instance().seed(1978);
+  IdManager::counter() = 0;
+
+  auto checksum = std::make_shared<ChecksumListener>();
+  MetricsHub::instance().clearListeners();
+  MetricsHub::instance().addListener(checksum);
+
+  // The same entities, ids and initial events whatever the partitioning
+  Simulator reference;
+  std::unique_ptr<ParallelSimulator> psim;
+  if (partitions > 0) {
+    psim = std::make_unique<ParallelSimulator>(
+        partitions, Config::get().UPLINK_LATENCY, QueueKind::BinaryHeap,
+        mode);
+  }
+  auto place = [&](Model &model, size_t r) -> Simulator & {
+    if (!psim) return reference;
+    psim->assign(model, r % partitions);
+    return psim->partition(r % partitions);
+  };
+
+  std::vector<RSU::PtrRSU> all_rsus;
+  for (size_t r = 0; r < rsus; ++r) {
+    auto rsu = std::make_shared<RSU>();
+    place(*rsu, r);
+    all_rsus.push_back(rsu);
+  }
+
+  std::vector<Vehicle::PtrVehicle> fleet;
+  for (size_t v = 0; v < vehicles; ++v) {
+    auto vehicle = std::make_shared<Vehicle>(std::make_shared<RandomPolicy>());
+    std::vector<RSU::PtrRSU> cell = {all_rsus[v % rsus]};
+    if (rsus > 1) cell.push_back(all_rsus[(v + 1) % rsus]);
+    vehicle->set_rsus(cell);
+    place(*vehicle, v % rsus)
+        .schedule<TaskGenerationEvent>(1.0, vehicle,
+                                       Config::get().TRAFFIC_LAMBDA);
+    fleet.push_back(vehicle);
+  }
+
+  auto t0 = std::chrono::steady_clock::now();
+  if (psim) {
+    psim->run(duration, threads);
+  } else {
+    reference.run(duration);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+
+  MetricsHub::instance().clearListeners();
+  Result result{std::chrono::duration<double>(t1 - t0).count(),
+                reference.events_executed(),
+                0,
+                0,
+                0,
+                checksum->hash,
+                checksum->records};
+  if (psim) {
+    const auto &st = psim->get_stats();
+    result.events = st.events;
+    result.windows = st.windows;
+    result.messages = st.messages;
+    result.rolled_back = st.rolled_back;
+  }
+  return result;
+}
+
+void print(const std::string &engine, size_t partitions, size_t threads,
+           const Result &r, double base_wall) {
+  cout << std::left << std::setw(14) << engine << std::right << std::setw(6)
+       << (partitions > 0 ? std::to_string(partitions) : "-") << std::setw(9)
+       << threads << std::fixed << std::setw(10) << std::setprecision(3)
+       << r.wall << std::setw(14) << std::setprecision(0) << r.events / r.wall
+       << std::setw(10) << std::setprecision(2) << base_wall / r.wall
+       << std::setw(10) << r.windows << std::setw(12) << r.messages << std::setw(12)
+       << r.rolled_back << std::setw(20) << std::hex << r.hash << std::dec
+       << endl;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t vehicles = argc > 1 ? std::stoul(argv[1]) : 2000;
+  size_t rsus = argc > 2 ? std::stoul(argv[2]) : 32;
+  size_t partitions = argc > 3 ? std::stoul(argv[3]) : 16;
+  double duration = argc > 4 ? std::stod(argv[4]) : 50.0;
+  size_t max_threads = argc > 5 ? std::stoul(argv[5])
+                                : std::thread::hardware_concurrency();
+  if (max_threads == 0) max_threads = 1;
+  std::string which = argc > 6 ? argv[6] : "conservative";
+  std::vector<SyncMode> modes;
+  if (which != "optimistic") modes.push_back(SyncMode::Conservative);
+  if (which != "conservative") modes.push_back(SyncMode::Optimistic);
+  bool chaos = false;
+  Config::Parameters &config = Config::get();
+  for (int i = 7; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "chaos") {
+      chaos = true;
+    } else if (arg.rfind("uplink=", 0) == 0) {
+      config.UPLINK_LATENCY = std::stod(arg.substr(7));
+    }
+  }
+  if (config.UPLINK_LATENCY <= 0.0) {
+    std::cerr << "pdes_benchmark: the model has no lookahead "
+                 "(UPLINK_LATENCY = 0); pass uplink=SECONDS"
+              << endl;
+    return 2;
+  }
+
+  Logger::instance().setTrace(false);
+  if (chaos) config.set_chaos_mode();
+
+  cout << "PDES scaling: " << vehicles << " vehicles, " << rsus << " RSUs, "
+       << partitions << " partitions, " << duration
+       << " s, lookahead=" << config.UPLINK_LATENCY << " s"
+       << (chaos ? ", chaos mode" : "") << endl;
+  cout << std::left << std::setw(14) << "Engine" << std::right
+       << std::setw(6) << "LPs" << std::setw(9) << "Threads" << std::setw(10)
+       << "Wall(s)" << std::setw(14) << "Events/s" << std::setw(10)
+       << "Speedup" << std::setw(10) << "Windows" << std::setw(12)
+       << "Messages" << std::setw(12) << "RolledBack" << std::setw(20)
+       << "Checksum" << endl;
+  cout << std::string(117, '-') << endl;
+
+  // Speedups are relative to the sequential engine
+  Result reference =
+      run_once(vehicles, rsus, 0, duration, 1, SyncMode::Conservative);
+  print("sequential", 0, 1, reference, reference.wall);
+  bool identical = true;
+  for (SyncMode mode : modes) {
+    const char *name =
+        mode == SyncMode::Optimistic ? "optimistic" : "conservative";
+    // 1 partition, then P partitions on 1, 2, 4, ... and max_threads threads
+    Result single = run_once(vehicles, rsus, 1, duration, 1, mode);
+    print(name, 1, 1, single, reference.wall);
+    identical = identical && single.hash == reference.hash &&
+                single.records == reference.records;
+    for (size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+      Result r = run_once(vehicles, rsus, partitions, duration, threads, mode);
+      print(name, partitions, threads, r, reference.wall);
+      identical = identical && r.hash == reference.hash &&
+                  r.records == reference.records;
+      if (threads == max_threads) break;
+    }
+  }
+  cout << (identical ? "Results identical to the sequential run"
+                     : "MISMATCH with the sequential run")
+       << endl;
+  return identical ? 0 : 1;
+}
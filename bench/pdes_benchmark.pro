@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = pdes_benchmark
+
+include(bench.pri)
+
+SOURCES += pdes_benchmark.cpp
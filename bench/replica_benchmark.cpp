@@ -0,0 +1,179 @@
+/**
+ * @file replica_benchmark.cpp
+ * @brief Independent replicas in one process, one SimContext each
+ *
+ * Runs N replicas (seeds 1978, 1979, ...) of a V-vehicle / R-RSU scenario
+ * three ways: one at a time on the process-wide singletons (reference), one
+ * at a time through run_replicas(), and concurrently on T threads. The
+ * metric stream of every replica is hashed; all three runs must agree
+ * replica by replica.
+ *
+ * Usage:
+ *   ./replica_benchmark [replicas] [vehicles] [rsus] [duration] [threads]
+ *                       [--chaos]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/ChaosManager.h"
+#include "core/Config.h"
+#include "core/SimContext.h"
+#include "core/Simulator.h"
+#include "events/TaskGenerationEvent.h"
+#include "logger.h"
+#include "metric.h"
+#include "model/RSU.h"
+#include "model/RandomPolicy.h"
+#include "model/Vehicle.h"
+#include "utils/Rng.h"
+
+using std::cout, std::endl;
+
+namespace {
+
+constexpr int BASE_SEED = 1978;
+
+// FNV-1a over every metric field, in delivery order
+class ChecksumListener : public IMetricListener {
+ public:
+  uint64_t hash = 1469598103934665603ull;
+
+  void mix(const void *data, size_t n) {
+    const auto *p = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < n; ++i) {
+      hash ^= p[i];
+      hash *= 1099511628211ull;
+    }
+  }
+
+  void onMetricRecorded(const MetricRecord &rec) override {
+    mix(&rec.time, sizeof(rec.time));
+    mix(&rec.entity_id, sizeof(rec.entity_id));
+    mix(rec.metric_name().data(), rec.metric_name().size());
+    mix(&rec.value, sizeof(rec.value));
+    mix(rec.tag_name().data(), rec.tag_name().size());
+    mix(&rec.task_id, sizeof(rec.task_id));
+  }
+};
+
+// One replica on whatever streams are bound to the calling thread
+uint64_t run_replica(size_t vehicles, size_t rsus, double duration) {
+  auto checksum = std::make_shared<ChecksumListener>();
+  MetricsHub::instance().clearListeners();
+  MetricsHub::instance().addListener(checksum);
+
+  Simulator sim;
+  std::vector<RSU::PtrRSU> stations;
+  for (size_t r = 0; r < rsus; ++r) {
+    auto rsu = std::make_shared<RSU>();
+    rsu->battery = Battery(10000.0);
+    stations.push_back(rsu);
+  }
+  std::vector<Vehicle::PtrVehicle> fleet;
+  for (size_t v = 0; v < vehicles; ++v) {
+    auto vehicle = std::make_shared<Vehicle>(std::make_shared<RandomPolicy>());
+    vehicle->set_rsus(stations);
+    vehicle->battery = Battery(10000.0);
+    sim.schedule<TaskGenerationEvent>(1.0, vehicle,
+                                      Config::get().TRAFFIC_LAMBDA);
+    fleet.push_back(vehicle);
+  }
+  sim.run(duration);
+
+  MetricsHub::instance().clearListeners();
+  return checksum->hash;
+}
+
+std::vector<std::unique_ptr<SimContext>> make_contexts(size_t replicas) {
+  std::vector<std::unique_ptr<SimContext>> contexts;
+  for (size_t i = 0; i < replicas; ++i) {
+    contexts.push_back(
+        std::make_unique<SimContext>(BASE_SEED + static_cast<int>(i)));
+  }
+  return contexts;
+}
+
+double run_contexts(size_t replicas, size_t vehicles, size_t rsus,
+                    double duration, size_t threads,
+                    std::vector<uint64_t> &hashes) {
+  auto contexts = make_contexts(replicas);
+  hashes.assign(replicas, 0);
+  auto t0 = std::chrono::steady_clock::now();
+  run_replicas(
+      contexts,
+      [&](SimContext &, size_t i) {
+        hashes[i] = run_replica(vehicles, rsus, duration);
+      },
+      threads);
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(t1 - t0).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t replicas = argc > 1 ? std::stoul(argv[1]) : 8;
+  size_t vehicles = argc > 2 ? std::stoul(argv[2]) : 50;
+  size_t rsus = argc > 3 ? std::stoul(argv[3]) : 4;
+  double duration = argc > 4 ? std::stod(argv[4]) : 50.0;
+  size_t threads = argc > 5 ? std::stoul(argv[5])
+                            : std::thread::hardware_concurrency();
+  if (threads == 0) threads = 1;
+  if (argc > 6 && std::string(argv[6]) == "--chaos") Config::set_chaos_mode();
+
+  Logger::instance().setTrace(false);
+  cout << "Replicas: " << replicas << " x (" << vehicles << " vehicles, "
+       << rsus << " RSUs, " << duration << " s), threads=" << threads
+       << (Config::get().FIELD_TOTAL_CHAOS ? ", chaos" : "") << endl;
+
+  // Reference: process-wide singletons, reseeded per replica
+  std::vector<uint64_t> global(replicas);
+  auto t0 = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < replicas; ++i) {
+    Rng::streams().seed(BASE_SEED + static_cast<int>(i));
+    ChaosManager::instance().reset();
+    ChaosManager::instance().seed(BASE_SEED + static_cast<int>(i));
+    IdManager::counter() = 0;
+    global[i] = run_replica(vehicles, rsus, duration);
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  double global_wall = std::chrono::duration<double>(t1 - t0).count();
+
+  std::vector<uint64_t> serial, concurrent;
+  double serial_wall =
+      run_contexts(replicas, vehicles, rsus, duration, 1, serial);
+  double concurrent_wall =
+      run_contexts(replicas, vehicles, rsus, duration, threads, concurrent);
+
+  cout << std::left << std::setw(22) << "Run" << std::right << std::setw(10)
+       << "Wall(s)" << std::setw(10) << "Speedup" << endl;
+  cout << std::string(42, '-') << endl;
+  auto row = [&](const char *name, double wall) {
+    cout << std::left << std::setw(22) << name << std::right << std::fixed
+         << std::setw(10) << std::setprecision(3) << wall << std::setw(10)
+         << std::setprecision(2) << global_wall / wall << endl;
+  };
+  row("global (sequential)", global_wall);
+  row("contexts, 1 thread", serial_wall);
+  row("contexts, concurrent", concurrent_wall);
+
+  bool identical = true;
+  for (size_t i = 0; i < replicas; ++i) {
+    bool same = global[i] == serial[i] && global[i] == concurrent[i];
+    identical = identical && same;
+    cout << "replica " << std::setw(3) << i << "  " << std::hex
+         << std::setw(16) << global[i] << std::dec
+         << (same ? "" : "  MISMATCH") << endl;
+  }
+  cout << (identical ? "Results identical across runs"
+                     : "MISMATCH between runs")
+       << endl;
+  return identical ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = replica_benchmark
+
+include(bench.pri)
+
+SOURCES += replica_benchmark.cpp
@@ -0,0 +1,194 @@
+/**
+ * @file rng_benchmark.cpp
+ * @brief Variates/sec of the previous Rng (std::mt19937 with a distribution
+ * constructed per draw) against the counter-based Rng, per draw and batched
+ *
+ * Before timing, checks that batched draws equal the same number of single
+ * draws, that the AVX2 and scalar block paths agree and that random access
+ * (at) and jump-ahead (discard) match sequential generation. Exits non-zero
+ * on any mismatch.
+ *
+ * Usage:
+ *   ./rng_benchmark [variates_per_point]
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "utils/Philox.h"
+#include "utils/Rng.h"
+
+using std::cout, std::endl;
+
+namespace {
+
+volatile double sink;
+
+// Per-call draws as the previous Rng made them
+struct Legacy {
+  std::mt19937 engine{1978};
+
+  double uniform() {
+    std::uniform_real_distribution<double> d(0.0, 1.0);
+    return d(engine);
+  }
+  double exponential() {
+    std::exponential_distribution<double> d(0.2);
+    return d(engine);
+  }
+  double normal() {
+    std::normal_distribution<double> d(0.0, 1.0);
+    return d(engine);
+  }
+};
+
+template <typename F>
+double rate(size_t n, F &&body) {
+  auto t0 = std::chrono::steady_clock::now();
+  body();
+  auto t1 = std::chrono::steady_clock::now();
+  return n / std::chrono::duration<double>(t1 - t0).count();
+}
+
+bool verify() {
+  bool ok = true;
+  auto check = [&](bool cond, const char *what) {
+    if (!cond) cout << "MISMATCH: " << what << endl;
+    ok = ok && cond;
+  };
+
+  const size_t n = 1003;  // not a multiple of the block or batch size
+  std::vector<double> single(n), batch(n);
+  auto compare = [&](const char *what, auto draw, auto fill) {
+    Rng::streams().seed(42);
+    Rng::engine(Rng::TASK).discard(3);  // start mid-block
+    for (double &v : single) v = draw();
+    Rng::Engine after = Rng::engine(Rng::TASK);
+    Rng::streams().seed(42);
+    Rng::engine(Rng::TASK).discard(3);
+    fill(batch.data());
+    check(single == batch && after == Rng::engine(Rng::TASK), what);
+  };
+  compare(
+      "fill_uniform", [] { return Rng::uniform(Rng::TASK, -1.0, 3.0); },
+      [&](double *out) { Rng::fill_uniform(Rng::TASK, out, n, -1.0, 3.0); });
+  compare(
+      "fill_exponential", [] { return Rng::exponential(Rng::TASK, 0.2); },
+      [&](double *out) { Rng::fill_exponential(Rng::TASK, out, n, 0.2); });
+  compare(
+      "fill_normal", [] { return Rng::normal(Rng::TASK, 5.0, 2.0); },
+      [&](double *out) { Rng::fill_normal(Rng::TASK, out, n, 5.0, 2.0); });
+
+  Philox4x32 engine(7, 1, 2);
+  std::vector<uint32_t> scalar(4 * 64), simd(4 * 64);
+  engine.generate_blocks(1ull << 32, 64, scalar.data(), false);
+  engine.generate_blocks(1ull << 32, 64, simd.data(), true);
+  check(scalar == simd, "AVX2 blocks");
+
+  Philox4x32 seq(7, 1, 2), jump(7, 1, 2);
+  jump.discard(1000);
+  for (int i = 0; i < 1000; ++i) seq();
+  uint32_t next = seq();
+  check(next == jump() && next == engine.at(1000), "discard / at");
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t n = 20000000;
+  if (argc > 1) n = std::stoul(argv[1]);
+
+  cout << "AVX2: " << (Philox4x32::avx2_supported() ? "yes" : "no") << endl;
+  if (!verify()) return 1;
+  cout << "Batched, scalar and AVX2 draws identical" << endl << endl;
+
+  std::vector<double> out(4096);
+  Legacy legacy;
+  Rng::Streams streams(1978);
+  Rng::Streams *previous = Rng::bind(&streams);
+
+  // Batched draws in chunks of out.size()
+  auto batched = [&](bool simd, auto fill) {
+    Philox4x32::simd() = simd;
+    return rate(n, [&] {
+      for (size_t done = 0; done < n; done += out.size()) {
+        fill(out.data(), out.size());
+        sink = out[0];
+      }
+    });
+  };
+
+  struct Row {
+    const char *name;
+    double legacy, single, scalar, avx2;
+  };
+  std::vector<Row> rows;
+
+  rows.push_back(
+      {"uniform",
+       rate(n, [&] { for (size_t i = 0; i < n; ++i) sink = legacy.uniform(); }),
+       rate(n,
+            [&] {
+              for (size_t i = 0; i < n; ++i)
+                sink = Rng::uniform(Rng::TASK, 0.0, 1.0);
+            }),
+       batched(false,
+               [](double *o, size_t m) { Rng::fill_uniform(Rng::TASK, o, m); }),
+       batched(true, [](double *o, size_t m) {
+         Rng::fill_uniform(Rng::TASK, o, m);
+       })});
+  rows.push_back(
+      {"exponential",
+       rate(n,
+            [&] { for (size_t i = 0; i < n; ++i) sink = legacy.exponential(); }),
+       rate(n,
+            [&] {
+              for (size_t i = 0; i < n; ++i)
+                sink = Rng::exponential(Rng::ARRIVALS, 0.2);
+            }),
+       batched(false,
+               [](double *o, size_t m) {
+                 Rng::fill_exponential(Rng::ARRIVALS, o, m, 0.2);
+               }),
+       batched(true, [](double *o, size_t m) {
+         Rng::fill_exponential(Rng::ARRIVALS, o, m, 0.2);
+       })});
+  rows.push_back(
+      {"normal",
+       rate(n, [&] { for (size_t i = 0; i < n; ++i) sink = legacy.normal(); }),
+       rate(n,
+            [&] {
+              for (size_t i = 0; i < n; ++i)
+                sink = Rng::normal(Rng::TASK, 0.0, 1.0);
+            }),
+       batched(false,
+               [](double *o, size_t m) {
+                 Rng::fill_normal(Rng::TASK, o, m, 0.0, 1.0);
+               }),
+       batched(true, [](double *o, size_t m) {
+         Rng::fill_normal(Rng::TASK, o, m, 0.0, 1.0);
+       })});
+  Philox4x32::simd() = true;
+  Rng::bind(previous);
+
+  cout << "Variates/s (" << n << " per point)" << endl;
+  cout << std::left << std::setw(13) << "Draw" << std::right << std::setw(14)
+       << "mt19937" << std::setw(14) << "Philox" << std::setw(14)
+       << "batch scalar" << std::setw(14) << "batch AVX2" << std::setw(10)
+       << "Speedup" << endl;
+  cout << std::string(79, '-') << endl;
+  for (const Row &r : rows) {
+    cout << std::left << std::setw(13) << r.name << std::right << std::fixed
+         << std::setprecision(0) << std::setw(14) << r.legacy << std::setw(14)
+         << r.single << std::setw(14) << r.scalar << std::setw(14) << r.avx2
+         << std::setw(10) << std::setprecision(2) << r.avx2 / r.legacy
+         << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = rng_benchmark
+
+include(bench.pri)
+
+SOURCES += rng_benchmark.cpp
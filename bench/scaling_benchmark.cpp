@@ -0,0 +1,258 @@
+/**
+ * @file scaling_benchmark.cpp
+ * @brief Engine cost over topology size and load: vehicles x RSUs x lambda
+ *
+ * Every point builds a synthetic topology in a fresh SimContext: V vehicles,
+ * each with its own policy instance (Random by default; a shared instance
+ * would serialize all decisions), R RSUs, vehicle v reaching RSUs v mod R
+ * and v+1 mod R (its cell and the next one), each vehicle generating tasks
+ * at TRAFFIC_LAMBDA. It is run for the simulated duration
+ * with a counting metrics listener and trace logging off, and reports
+ * events/s, simulated seconds per wall second, wall time per generated task
+ * and peak RSS. Peak RSS is reset before each point where Linux allows it
+ * (/proc/self/clear_refs), otherwise it is the process peak so far.
+ *
+ * --json=FILE writes one line per point for comparison across changes.
+ *
+ * Usage:
+ *   ./scaling_benchmark [--vehicles=10,100,1000] [--rsus=1,10,50]
+ *                       [--lambda=1.25,2.5,5] [--duration=20]
+ *                       [--policy=Random] [--queue=heap] [--seed=1978]
+ *                       [--json=FILE]
+ */
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/Config.h"
+#include "core/SimContext.h"
+#include "core/Simulator.h"
+#include "events/TaskGenerationEvent.h"
+#include "metric.h"
+#include "model/Policies.h"
+#include "model/RSU.h"
+#include "model/Vehicle.h"
+
+using std::cout, std::endl;
+
+namespace {
+
+class CountingListener : public IMetricListener {
+ public:
+  uint64_t records = 0;
+  void onMetricRecorded(const MetricRecord &) override { ++records; }
+};
+
+struct Point {
+  size_t vehicles;
+  size_t rsus;
+  double lambda;
+};
+
+struct Result {
+  double wall;
+  uint64_t events;
+  uint64_t tasks;
+  uint64_t records;
+  size_t peak_pending;
+  double peak_rss_mb;
+};
+
+template <typename T>
+std::vector<T> parse_list(const std::string &s) {
+  std::vector<T> values;
+  std::stringstream ss(s);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    std::istringstream in(item);
+    T v;
+    if (in >> v) values.push_back(v);
+  }
+  return values;
+}
+
+// Starts a new peak-RSS interval; false when the kernel does not allow it
+bool reset_peak_rss() {
+  std::ofstream clear("/proc/self/clear_refs");
+  clear << "5";
+  clear.flush();
+  return static_cast<bool>(clear);
+}
+
+double peak_rss_mb() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::stod(line.substr(6)) / 1024.0;  // kB
+    }
+  }
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+
+Result run_point(const Point &point, double duration,
+                 const std::string &policy_name, QueueKind queue, int seed) {
+  Config::Parameters config = Config::defaults();
+  config.TRAFFIC_LAMBDA = point.lambda;
+  SimContext context(seed, config);
+  SimContext::Scope scope(&context);
+  auto counter = std::make_shared<CountingListener>();
+  MetricsHub::instance().addListener(counter);
+
+  Result result{};
+  {
+    Simulator sim(queue);
+    std::vector<RSU::PtrRSU> rsus;
+    for (size_t r = 0; r < point.rsus; ++r) {
+      rsus.push_back(std::make_shared<RSU>());
+      rsus.back()->battery = Battery(10000.0);
+    }
+    std::vector<Vehicle::PtrVehicle> fleet;
+    for (size_t v = 0; v < point.vehicles; ++v) {
+      auto vehicle = std::make_shared<Vehicle>(create_policy(policy_name));
+      std::vector<RSU::PtrRSU> cell = {rsus[v % rsus.size()]};
+      if (rsus.size() > 1) cell.push_back(rsus[(v + 1) % rsus.size()]);
+      vehicle->set_rsus(cell);
+      vehicle->battery = Battery(10000.0);
+      sim.schedule<TaskGenerationEvent>(1.0, vehicle, point.lambda);
+      fleet.push_back(vehicle);
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    sim.run(duration);
+    auto t1 = std::chrono::steady_clock::now();
+
+    result.wall = std::chrono::duration<double>(t1 - t0).count();
+    result.events = sim.engine_stats().dispatched;
+    result.peak_pending = sim.engine_stats().peak_pending;
+    for (const auto &vehicle : fleet) {
+      result.tasks += vehicle->get_tasks_created();
+    }
+    // Before the topology is released
+    result.peak_rss_mb = peak_rss_mb();
+  }
+  result.records = counter->records;
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::vector<size_t> vehicle_counts = {10, 100, 1000};
+  std::vector<size_t> rsu_counts = {1, 10, 50};
+  double base_lambda = Config::defaults().TRAFFIC_LAMBDA;
+  std::vector<double> lambdas = {base_lambda / 2, base_lambda,
+                                 base_lambda * 2};
+  double duration = 20.0;
+  std::string policy = "Random";
+  QueueKind queue = QueueKind::BinaryHeap;
+  int seed = 1978;
+  std::string json_file;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&](const char *flag) { return arg.substr(strlen(flag)); };
+    if (arg.rfind("--vehicles=", 0) == 0) {
+      vehicle_counts = parse_list<size_t>(value("--vehicles="));
+    } else if (arg.rfind("--rsus=", 0) == 0) {
+      rsu_counts = parse_list<size_t>(value("--rsus="));
+    } else if (arg.rfind("--lambda=", 0) == 0) {
+      lambdas = parse_list<double>(value("--lambda="));
+    } else if (arg.rfind("--duration=", 0) == 0) {
+      duration = std::stod(value("--duration="));
+    } else if (arg.rfind("--policy=", 0) == 0) {
+      policy = value("--policy=");
+    } else if (arg.rfind("--queue=", 0) == 0) {
+      if (!parse_queue_kind(value("--queue="), queue)) {
+        std::cerr << "Unknown queue '" << value("--queue=")
+                  << "' (expected heap, calendar or radix)" << endl;
+        return 1;
+      }
+    } else if (arg.rfind("--seed=", 0) == 0) {
+      seed = std::stoi(value("--seed="));
+    } else if (arg.rfind("--json=", 0) == 0) {
+      json_file = value("--json=");
+    } else {
+      std::cerr << "Unknown option '" << arg << "'" << endl;
+      return 1;
+    }
+  }
+  for (size_t r : rsu_counts) {
+    if (r == 0) {
+      std::cerr << "--rsus: every point needs at least one RSU" << endl;
+      return 1;
+    }
+  }
+
+  cout << "Scaling benchmark: " << policy << " policy, "
+       << queue_kind_name(queue) << " queue, " << duration
+       << " simulated s per point, seed " << seed << endl;
+  cout << std::right << std::setw(9) << "Vehicles" << std::setw(6) << "RSUs"
+       << std::setw(8) << "Lambda" << std::setw(12) << "Events"
+       << std::setw(13) << "Events/s" << std::setw(10) << "Sim-s/s"
+       << std::setw(10) << "Tasks" << std::setw(10) << "ns/task"
+       << std::setw(10) << "Pending" << std::setw(11) << "RSS(MB)" << endl;
+  cout << std::string(99, '-') << endl;
+
+  std::ofstream json;
+  if (!json_file.empty()) json.open(json_file);
+  json << std::setprecision(6) << "{\"benchmark\": \"scaling\", \"policy\": \""
+       << policy << "\", \"queue\": \"" << queue_kind_name(queue)
+       << "\", \"duration\": " << duration << ", \"seed\": " << seed
+       << ", \"points\": [";
+
+  bool rss_exact = true;
+  bool first = true;
+  for (size_t v : vehicle_counts) {
+    for (size_t r : rsu_counts) {
+      for (double lambda : lambdas) {
+        rss_exact = reset_peak_rss() && rss_exact;
+        Point point{v, r, lambda};
+        Result res = run_point(point, duration, policy, queue, seed);
+        double wall = std::max(res.wall, 1e-9);
+        double ns_per_task = res.tasks ? res.wall * 1e9 / res.tasks : 0.0;
+        cout << std::fixed << std::setw(9) << v << std::setw(6) << r
+             << std::setw(8) << std::setprecision(2) << lambda
+             << std::setw(12) << res.events << std::setw(13)
+             << std::setprecision(0) << res.events / wall << std::setw(10)
+             << std::setprecision(1) << duration / wall << std::setw(10)
+             << res.tasks << std::setw(10) << std::setprecision(0)
+             << ns_per_task << std::setw(10) << res.peak_pending
+             << std::setw(11) << std::setprecision(1) << res.peak_rss_mb
+             << endl;
+        json << (first ? "\n" : ",\n") << "  {\"vehicles\": " << v
+             << ", \"rsus\": " << r << ", \"lambda\": " << lambda
+             << ", \"wall_s\": " << res.wall << ", \"events\": " << res.events
+             << ", \"events_per_s\": " << res.events / wall
+             << ", \"sim_s_per_wall_s\": " << duration / wall
+             << ", \"tasks\": " << res.tasks
+             << ", \"ns_per_task\": " << ns_per_task
+             << ", \"metric_records\": " << res.records
+             << ", \"peak_pending\": " << res.peak_pending
+             << ", \"peak_rss_mb\": " << res.peak_rss_mb << "}";
+        first = false;
+      }
+    }
+  }
+  json << "\n]}\n";
+
+  if (!rss_exact) {
+    cout << "(peak RSS could not be reset: values are the process peak so "
+            "far)"
+         << endl;
+  }
+  if (!json_file.empty()) cout << "Results written to " << json_file << endl;
+  return 0;
+}
@@ -0,0 +1,6 @@
+TEMPLATE = app
+TARGET = scaling_benchmark
+
+include(bench.pri)
+
+SOURCES += scaling_benchmark.cpp
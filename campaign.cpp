@@ -0,0 +1,506 @@
+/**
+ * @file campaign.cpp
+ * @brief Policy x seed x parameter-grid campaign in a single process
+ *
+ * Runs every (policy, grid point, seed) replica of the main.cpp scenario on a
+ * work-stealing thread pool, one SimContext per replica, and aggregates the
+ * metric stream in process (no per-run CSV) into
+ * <out>/aggregated_summary.csv and <out>/aggregated_timeseries.csv, the
+ * inputs of scripts/dashboard_fast.py.
+ *
+ * Each finished replica is appended to <out>/campaign_journal.tsv. Running
+ * the same campaign again skips the replicas found there, so an interrupted
+ * campaign resumes where it stopped; --fresh discards the journal.
+ *
+ * With --warmup=T the interval [0, T] is simulated once per (grid point,
+ * seed) under the baseline policy and snapshotted; every policy then forks
+ * from that snapshot, and its statistics cover (T, duration] only.
+ *
+ * Usage:
+ *   ./campaign [--policies=Local,Random,Intelligent,FirstRemote]
+ *              [--repeats=50] [--base-seed=1978] [--duration=700] [--chaos]
+ *              [--param=NAME=v1,v2,...]... [--threads=N] [--out=results]
+ *              [--baseline=POLICY] [--warmup=T] [--fresh]
+ *
+ * Seeds are base-seed + 1 .. base-seed + repeats. NAME is a field of
+ * Config::Parameters (TRAFFIC_LAMBDA, CHAOS_INTENSITY, TASK_MAX_SIZE, ...);
+ * several --param options span their cartesian product.
+ *
+ * Every policy sees the same workload for a given seed (per-purpose RNG
+ * streams), so policies are compared pairwise by seed against the baseline
+ * (default: first policy); <out>/variance_reduction.csv reports the variance
+ * reduction of these paired comparisons over independent runs.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/Config.h"
+#include "core/SimContext.h"
+#include "core/Simulator.h"
+#include "core/Snapshot.h"
+#include "events/TaskGenerationEvent.h"
+#include "metric.h"
+#include "model/MetricNames.h"
+#include "model/Policies.h"
+#include "model/RSU.h"
+#include "model/Vehicle.h"
+#include "tools/Aggregation.h"
+#include "utils/WorkStealingPool.h"
+
+using std::cout, std::cerr, std::endl;
+
+namespace {
+
+using GridPoint = std::vector<std::pair<std::string, double>>;
+
+struct Options {
+  std::vector<std::string> policies = policy_names();
+  int repeats = 50;
+  int base_seed = 1978;
+  double duration = 700.0;
+  bool chaos = false;
+  std::vector<std::pair<std::string, std::vector<double>>> grid;
+  size_t threads = std::thread::hardware_concurrency();
+  std::string out = "results";
+  std::string baseline;  // first policy when empty
+  double warmup = 0.0;   // shared warm-up, 0: none
+  bool fresh = false;
+};
+
+struct Job {
+  std::string policy;
+  int seed;
+  GridPoint point;
+  std::string label;  // "NAME=value;..." of the grid point
+
+  // Identifies the replica in the journal
+  std::string key(const Options &opt) const {
+    std::ostringstream ss;
+    ss << std::setprecision(17) << policy << '\t' << seed << '\t' << label
+       << '\t' << opt.duration;
+    if (opt.warmup > 0.0) ss << " warmup=" << opt.warmup;
+    ss << '\t' << (opt.chaos ? "chaos" : "stable");
+    return ss.str();
+  }
+
+  // Replicas sharing a warm-up
+  std::string group() const { return std::to_string(seed) + '\t' + label; }
+};
+
+// Warm-up of one (seed, grid point), simulated by the first replica that
+// needs it
+struct Warmup {
+  std::once_flag once;
+  Snapshot snapshot;
+};
+
+std::vector<std::string> split(const std::string &s, char sep) {
+  std::vector<std::string> parts;
+  std::stringstream ss(s);
+  std::string part;
+  while (std::getline(ss, part, sep)) parts.push_back(part);
+  return parts;
+}
+
+bool set_parameter(Config::Parameters &p, const std::string &name,
+                   double value) {
+  if (name == "TRAFFIC_LAMBDA") {
+    p.TRAFFIC_LAMBDA = value;
+  } else if (name == "CHAOS_INTENSITY") {
+    p.CHAOS_INTENSITY = value;
+  } else if (name == "UPLINK_LATENCY") {
+    p.UPLINK_LATENCY = value;
+  } else if (name == "TASK_MIN_SIZE") {
+    p.TASK_MIN_SIZE = static_cast<long>(value);
+  } else if (name == "TASK_MAX_SIZE") {
+    p.TASK_MAX_SIZE = static_cast<long>(value);
+  } else if (name == "TASK_MEAN_DENSITY") {
+    p.TASK_MEAN_DENSITY = static_cast<long>(value);
+  } else if (name == "TASK_STD_DENSITY") {
+    p.TASK_STD_DENSITY = static_cast<long>(value);
+  } else if (name == "TASK_MIN_DEADLINE") {
+    p.TASK_MIN_DEADLINE = value;
+  } else if (name == "TASK_MAX_DEADLINE") {
+    p.TASK_MAX_DEADLINE = value;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Feeds the metric stream of one replica into its SimulationStats
+class StatsListener : public IMetricListener {
+ public:
+  SimulationStats stats;
+
+  void onMetricRecorded(const MetricRecord &rec) override {
+    stats.add(rec.time, rec.metric_name(), rec.value, rec.tag_name());
+  }
+};
+
+Config::Parameters job_config(const Job &job) {
+  Config::Parameters config = Config::defaults();
+  for (const auto &[name, value] : job.point) {
+    set_parameter(config, name, value);
+  }
+  return config;
+}
+
+// main.cpp's scenario: three vehicles sharing one policy and one RSU
+struct Scenario {
+  std::vector<Vehicle::PtrVehicle> vehicles;
+  std::vector<RSU::PtrRSU> rsus;
+
+  // `start`: report the initial batteries and schedule the first arrivals
+  // (not when the state comes from a snapshot)
+  Scenario(Simulator &sim, const std::string &policy_name, bool start) {
+    auto policy = create_policy(policy_name);
+    for (int i = 0; i < 3; ++i) {
+      vehicles.push_back(std::make_shared<Vehicle>(policy));
+    }
+    rsus = {std::make_shared<RSU>()};
+    for (auto r : rsus) {
+      r->battery = Battery(10000.0);
+      if (start) {
+        r->report_metric(sim, metrics::BatteryRemaining,
+                         r->battery.get_remaining());
+      }
+    }
+    for (auto v : vehicles) {
+      v->set_rsus(rsus);
+      v->battery = Battery(10000.0);
+      if (start) {
+        v->report_metric(sim, metrics::BatteryRemaining,
+                         v->battery.get_remaining());
+        sim.schedule<TaskGenerationEvent>(1.0, v,
+                                          Config::get().TRAFFIC_LAMBDA);
+      }
+    }
+  }
+
+  // Snapshot entity table
+  std::vector<Model *> models() const {
+    std::vector<Model *> table;
+    for (auto v : vehicles) table.push_back(v.get());
+    for (auto r : rsus) table.push_back(r.get());
+    return table;
+  }
+};
+
+// [0, warmup] under the baseline policy, metrics discarded
+Snapshot warm_up(const Job &job, const Options &opt) {
+  SimContext context(job.seed, job_config(job));
+  SimContext::Scope scope(&context);
+  Simulator sim;
+  Scenario scenario(sim, opt.baseline, true);
+  sim.run(opt.warmup);
+  return Snapshot::capture(sim, scenario.models());
+}
+
+RunSummary run_job(const Job &job, const Options &opt, Warmup *warmup) {
+  if (warmup) {
+    std::call_once(warmup->once,
+                   [&] { warmup->snapshot = warm_up(job, opt); });
+  }
+  SimContext context(job.seed, job_config(job));
+  SimContext::Scope scope(&context);
+
+  auto listener = std::make_shared<StatsListener>();
+  listener->stats.policy = job.policy;
+  listener->stats.filename = run_name(job.policy, job.seed);
+  MetricsHub::instance().addListener(listener);
+
+  Simulator sim;
+  Scenario scenario(sim, job.policy, !warmup);
+  if (warmup) warmup->snapshot.restore(sim, scenario.models());
+  sim.run(opt.duration);
+
+  RunSummary summary = summarize(listener->stats);
+  summary.params = job.label;
+  summary.seed = job.seed;
+  return summary;
+}
+
+// --------------------------------------------------
+// Journal: one line per finished replica
+// key fields \t filename \t figures \t series x3 \t "."
+// --------------------------------------------------
+
+void write_series(std::ostream &out, const TimeSeries &series) {
+  bool first = true;
+  for (const auto &[bin, val] : series) {
+    if (!first) out << ',';
+    out << bin << ':' << val.first << ':' << val.second;
+    first = false;
+  }
+}
+
+bool read_series(const std::string &field, TimeSeries &series) {
+  for (const auto &entry : split(field, ',')) {
+    auto parts = split(entry, ':');
+    if (parts.size() != 3) return false;
+    series[std::stoi(parts[0])] = {std::stod(parts[1]), std::stoi(parts[2])};
+  }
+  return true;
+}
+
+std::string journal_line(const std::string &key, const RunSummary &r) {
+  std::ostringstream out;
+  out << std::setprecision(17) << key << '\t' << r.filename << '\t'
+      << r.success_rate << ' ' << r.energy_cpu << ' ' << r.energy_tx << ' '
+      << r.latency_avg << ' ' << r.latency_p50 << ' ' << r.latency_p95 << ' '
+      << r.failures << ' ' << r.offload_local << ' ' << r.offload_remote
+      << ' ' << r.transfer_avg << '\t';
+  write_series(out, r.queue_series);
+  out << '\t';
+  write_series(out, r.queue_proc_series);
+  out << '\t';
+  write_series(out, r.battery_series);
+  out << "\t.\n";
+  return out.str();
+}
+
+// Key and summary of a complete journal line (a run cut short by a crash
+// leaves a truncated last line, which is ignored)
+std::optional<std::pair<std::string, RunSummary>> parse_journal_line(
+    const std::string &line) {
+  auto fields = split(line, '\t');
+  if (fields.size() != 11 || fields[10] != ".") return std::nullopt;
+  try {
+    RunSummary r;
+    r.policy = fields[0];
+    r.seed = std::stoi(fields[1]);
+    r.params = fields[2];
+    r.filename = fields[5];
+    std::istringstream figures(fields[6]);
+    figures >> r.success_rate >> r.energy_cpu >> r.energy_tx >>
+        r.latency_avg >> r.latency_p50 >> r.latency_p95 >> r.failures >>
+        r.offload_local >> r.offload_remote >> r.transfer_avg;
+    if (!figures) return std::nullopt;
+    if (!read_series(fields[7], r.queue_series) ||
+        !read_series(fields[8], r.queue_proc_series) ||
+        !read_series(fields[9], r.battery_series)) {
+      return std::nullopt;
+    }
+    std::string key = fields[0];
+    for (size_t i = 1; i < 5; ++i) key += '\t' + fields[i];
+    return std::make_pair(key, std::move(r));
+  } catch (...) {
+    return std::nullopt;
+  }
+}
+
+bool parse_options(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    auto value = [&](const std::string &flag) {
+      return arg.rfind(flag, 0) == 0 ? arg.substr(flag.size()) : "";
+    };
+    if (arg == "--chaos") {
+      opt.chaos = true;
+    } else if (arg == "--fresh") {
+      opt.fresh = true;
+    } else if (arg.rfind("--policies=", 0) == 0) {
+      opt.policies = split(value("--policies="), ',');
+    } else if (arg.rfind("--repeats=", 0) == 0) {
+      opt.repeats = std::stoi(value("--repeats="));
+    } else if (arg.rfind("--base-seed=", 0) == 0) {
+      opt.base_seed = std::stoi(value("--base-seed="));
+    } else if (arg.rfind("--duration=", 0) == 0) {
+      opt.duration = std::stod(value("--duration="));
+    } else if (arg.rfind("--threads=", 0) == 0) {
+      opt.threads = std::stoul(value("--threads="));
+    } else if (arg.rfind("--out=", 0) == 0) {
+      opt.out = value("--out=");
+    } else if (arg.rfind("--baseline=", 0) == 0) {
+      opt.baseline = value("--baseline=");
+    } else if (arg.rfind("--warmup=", 0) == 0) {
+      opt.warmup = std::stod(value("--warmup="));
+    } else if (arg.rfind("--param=", 0) == 0) {
+      std::string spec = value("--param=");
+      size_t eq = spec.find('=');
+      if (eq == std::string::npos) {
+        cerr << "Bad --param '" << spec << "' (expected NAME=v1,v2,...)"
+             << endl;
+        return false;
+      }
+      std::string name = spec.substr(0, eq);
+      Config::Parameters probe;
+      if (!set_parameter(probe, name, 0.0)) {
+        cerr << "Unknown parameter '" << name << "'" << endl;
+        return false;
+      }
+      std::vector<double> values;
+      for (const auto &v : split(spec.substr(eq + 1), ',')) {
+        values.push_back(std::stod(v));
+      }
+      if (values.empty()) {
+        cerr << "No values for parameter '" << name << "'" << endl;
+        return false;
+      }
+      opt.grid.push_back({name, values});
+    } else {
+      cerr << "Unknown option '" << arg << "'" << endl;
+      return false;
+    }
+  }
+  if (opt.threads == 0) opt.threads = 1;
+  if (opt.warmup < 0.0 || (opt.warmup > 0.0 && opt.warmup >= opt.duration)) {
+    cerr << "--warmup must lie in [0, duration)" << endl;
+    return false;
+  }
+  if (opt.baseline.empty() && !opt.policies.empty()) {
+    opt.baseline = opt.policies.front();
+  }
+  return true;
+}
+
+std::vector<GridPoint> grid_points(const Options &opt) {
+  std::vector<GridPoint> points = {{}};
+  for (const auto &[name, values] : opt.grid) {
+    std::vector<GridPoint> next;
+    for (const auto &point : points) {
+      for (double v : values) {
+        GridPoint p = point;
+        p.push_back({name, v});
+        next.push_back(p);
+      }
+    }
+    points = std::move(next);
+  }
+  return points;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  try {
+    if (!parse_options(argc, argv, opt)) return 1;
+  } catch (const std::exception &e) {
+    cerr << "Bad option value: " << e.what() << endl;
+    return 1;
+  }
+  if (opt.chaos) Config::set_chaos_mode();
+
+  std::vector<Job> jobs;
+  for (const auto &policy : opt.policies) {
+    for (const auto &point : grid_points(opt)) {
+      std::ostringstream label;
+      for (const auto &[name, v] : point) {
+        label << (label.tellp() > 0 ? ";" : "") << name << "=" << v;
+      }
+      for (int i = 1; i <= opt.repeats; ++i) {
+        jobs.push_back({policy, opt.base_seed + i, point, label.str()});
+      }
+    }
+  }
+
+  std::filesystem::create_directories(opt.out);
+  std::string journal_path = opt.out + "/campaign_journal.tsv";
+  if (opt.fresh) std::filesystem::remove(journal_path);
+
+  // Resume: replicas already in the journal are not run again
+  std::map<std::string, RunSummary> journaled;
+  {
+    std::ifstream in(journal_path);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (auto entry = parse_journal_line(line)) {
+        journaled[entry->first] = std::move(entry->second);
+      }
+    }
+  }
+  // One warm-up per (seed, grid point), shared by its policies
+  std::map<std::string, Warmup> warmups;
+  if (opt.warmup > 0.0) {
+    for (const Job &job : jobs) warmups[job.group()];
+  }
+
+  std::vector<std::optional<RunSummary>> results(jobs.size());
+  size_t resumed = 0;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    auto it = journaled.find(jobs[i].key(opt));
+    if (it != journaled.end()) {
+      results[i] = it->second;
+      ++resumed;
+    }
+  }
+
+  cout << "Campaign: " << opt.policies.size() << " policies x "
+       << grid_points(opt).size() << " grid points x " << opt.repeats
+       << " seeds, " << opt.duration << " s" << (opt.chaos ? ", chaos" : "")
+       << endl;
+  if (opt.warmup > 0.0) {
+    cout << "Shared warm-up: [0, " << opt.warmup << "] s under "
+         << opt.baseline << ", one per seed and grid point" << endl;
+  }
+  cout << "Replicas: " << jobs.size() << " (" << resumed
+       << " resumed from journal), threads: " << opt.threads << endl;
+
+  // Journal lines stay well-formed up to the last flushed replica
+  std::ofstream journal(journal_path, std::ios::app);
+  std::mutex journal_mtx;
+  size_t done = resumed;
+  auto t0 = std::chrono::steady_clock::now();
+  {
+    WorkStealingPool pool(opt.threads);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      if (results[i]) continue;
+      Warmup *warmup =
+          opt.warmup > 0.0 ? &warmups.at(jobs[i].group()) : nullptr;
+      pool.submit([&, i, warmup] {
+        RunSummary summary = run_job(jobs[i], opt, warmup);
+        std::lock_guard<std::mutex> lock(journal_mtx);
+        journal << journal_line(jobs[i].key(opt), summary) << std::flush;
+        results[i] = std::move(summary);
+        cout << "\rCompleted: " << ++done << "/" << jobs.size() << std::flush;
+      });
+    }
+    try {
+      pool.wait();
+    } catch (const std::exception &e) {
+      cerr << endl
+           << "Replica failed: " << e.what()
+           << " (finished replicas are kept in " << journal_path << ")"
+           << endl;
+      return 1;
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  cout << endl
+       << "Ran " << jobs.size() - resumed << " replicas in " << std::fixed
+       << std::setprecision(2)
+       << std::chrono::duration<double>(t1 - t0).count() << " s" << endl;
+
+  Aggregate aggregate;
+  for (const auto &r : results) aggregate.add(*r);
+  aggregate.write_summary(opt.out + "/aggregated_summary.csv");
+  aggregate.write_timeseries(opt.out + "/aggregated_timeseries.csv");
+  if (opt.policies.size() > 1 && opt.repeats > 1) {
+    cout << "Paired comparison against " << opt.baseline
+         << " (same seeds, same workload):" << endl;
+    aggregate.write_variance_reduction(opt.out + "/variance_reduction.csv",
+                                       opt.baseline, cout);
+  }
+  cout << "Generated:" << endl;
+  cout << "  - " << opt.out << "/aggregated_summary.csv" << endl;
+  cout << "  - " << opt.out << "/aggregated_timeseries.csv" << endl;
+  if (opt.policies.size() > 1 && opt.repeats > 1) {
+    cout << "  - " << opt.out << "/variance_reduction.csv" << endl;
+  }
+  return 0;
+}
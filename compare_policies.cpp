@@ -3,7 +3,8 @@
  * @brief Compare all policies on the same Oracle scenario tasks
  *
  * Usage:
- *   ./compare_policies [--chaos] [seed]
+ *   ./compare_policies [--chaos] [--stats] [--trace=FILE] [--binary-metrics]
+ *                      [seed]
  */
 
 #include <cmath>
@@ -11,25 +12,29 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <numeric>
-#include <sstream>
 #include <string>
 #include <vector>
 
 #include "core/ChaosManager.h"
 #include "core/Config.h"
 #include "core/Simulator.h"
+#include "core/Tracer.h"
 #include "events/SpecifiedTasksEvent.h"
 #include "logger.h"
 #include "metric.h"
+#include "metric_columns.h"
+#include "metric_stats.h"
 #include "model/DeterministicPolicy.h"
 #include "model/FirstRemotePolicy.h"
 #include "model/IntelligentPolicy.h"
+#include "model/MetricNames.h"
 #include "model/OffPolicy.h"
 #include "model/RSU.h"
 #include "model/RandomPolicy.h"
@@ -49,26 +54,27 @@ struct PolicyResult {
   double total_energy = 0.0;
   int local_count = 0;
   int remote_count = 0;
+  EngineStats engine;
 };
 
 PolicyResult run_with_policy(const std::string &policy_name,
                              std::shared_ptr<OffPolicy> policy, double duration,
                              int seed,
-                             const std::vector<ScenarioTask> &scenario_tasks) {
+                             const std::vector<ScenarioTask> &scenario_tasks,
+                             bool binary_metrics) {
   PolicyResult result;
   result.name = policy_name;
 
   // Reset seeds for reproducibility
-  Rng::engine().seed(seed);
+  Rng::streams().seed(seed);
   ChaosManager::instance().seed(seed);
   ChaosManager::instance().reset();
 
   // Create fresh copies of tasks
-  std::vector<Task::PtrTask> tasks;
+  std::vector<Task> tasks;
   for (const auto &st : scenario_tasks) {
-    auto task = std::make_shared<Task>(st.timestamp, st.size_bytes,
-                                       st.density_cycles_bytes, st.deadline);
-    tasks.push_back(task);
+    tasks.emplace_back(st.timestamp, st.size_bytes, st.density_cycles_bytes,
+                       st.deadline);
   }
 
   result.total_tasks = tasks.size();
@@ -77,7 +83,7 @@ PolicyResult run_with_policy(const std::string &policy_name,
   auto det_policy = std::dynamic_pointer_cast<DeterministicPolicy>(policy);
   if (det_policy) {
     for (size_t i = 0; i < tasks.size() && i < scenario_tasks.size(); ++i) {
-      det_policy->add_decision(tasks[i]->get_id(), scenario_tasks[i].decision);
+      det_policy->add_decision(tasks[i].get_id(), scenario_tasks[i].decision);
     }
   }
 
@@ -85,11 +91,23 @@ PolicyResult run_with_policy(const std::string &policy_name,
   Simulator sim;
 
   // Setup metrics file
-  std::string result_file =
-      "results/compare_" + policy_name + "_" + std::to_string(seed) + ".csv";
+  std::string result_file = "results/compare_" + policy_name + "_" +
+                            std::to_string(seed) +
+                            (binary_metrics ? ".mcol" : ".csv");
+  Logger::instance().open(
+      "logs/" + std::filesystem::path(result_file).stem().string() + ".log");
   MetricsHub::instance().clearListeners();
-  auto csvCollector = std::make_shared<CSVMetricsCollector>(result_file);
-  MetricsHub::instance().addListener(csvCollector);
+  std::shared_ptr<ColumnarMetricsCollector> columns;
+  std::shared_ptr<CSVMetricsCollector> csvCollector;
+  if (binary_metrics) {
+    columns = std::make_shared<ColumnarMetricsCollector>(result_file);
+    MetricsHub::instance().addListener(columns);
+  } else {
+    csvCollector = std::make_shared<CSVMetricsCollector>(result_file);
+    MetricsHub::instance().addListener(csvCollector);
+  }
+  auto statistics = std::make_shared<MetricStatistics>();
+  MetricsHub::instance().addListener(statistics);
 
   // Create RSUs
   std::vector<RSU::PtrRSU> rsus = {std::make_shared<RSU>()};
@@ -102,74 +120,42 @@ PolicyResult run_with_policy(const std::string &policy_name,
   vehicle->set_rsus(rsus);
   vehicle->battery = Battery(10000.0);
 
-  // Set tasks for SpecifiedTasksEvent
-  SpecifiedTasksEvent::reset();
-  SpecifiedTasksEvent::tasks = tasks;
-
-  // Schedule first task
+  // Schedule first task; each event schedules the next one
   if (!tasks.empty()) {
-    sim.schedule<SpecifiedTasksEvent>(tasks[0]->get_timestamp(), vehicle);
+    auto list = std::make_shared<const std::vector<Task>>(tasks);
+    sim.schedule<SpecifiedTasksEvent>(tasks[0].get_timestamp(), vehicle,
+                                      list);
   }
 
   // Run simulation
   sim.run(duration);
+  result.engine = sim.engine_stats();
 
-  // Force flush metrics - must flush before reading!
-  csvCollector->flush();
+  if (columns) columns->flush();
+  if (csvCollector) csvCollector->flush();
   MetricsHub::instance().clearListeners();
 
-  // Parse results from CSV
-  std::ifstream csv_file(result_file);
-  std::string line;
-  std::getline(csv_file, line);  // Skip header
-
-  std::vector<double> latencies;
-  double initial_battery = 10000.0;
-  double final_battery = 10000.0;
-
-  while (std::getline(csv_file, line)) {
-    std::stringstream ss(line);
-    std::string time_str, entity_str, metric, value_str, tag, taskid_str;
-    std::getline(ss, time_str, ',');
-    std::getline(ss, entity_str, ',');
-    std::getline(ss, metric, ',');
-    std::getline(ss, value_str, ',');
-    std::getline(ss, tag, ',');
-    std::getline(ss, taskid_str, ',');
-
-    double value = 0;
-    try {
-      value = std::stod(value_str);
-    } catch (...) {
-    }
-
-    if (metric == "TaskSuccess") {
-      if (value >= 0.5)
-        result.successful++;
-      else
-        result.failed++;
-    } else if (metric == "TaskLatency") {
-      latencies.push_back(value);
-    } else if (metric == "OffloadingType") {
-      if (value < 0.5)
-        result.local_count++;
-      else
-        result.remote_count++;
-    } else if (metric == "BatteryRemaining") {
-      final_battery = value;
-    }
+  // Results from the in-run statistics (TaskSuccess and OffloadingType are
+  // 0/1, so their sums count the successes and remote tasks)
+  if (const MetricSummary *s = statistics->metric(metrics::TaskSuccess)) {
+    result.successful = static_cast<int>(std::lround(s->stats.sum));
+    result.failed = static_cast<int>(s->stats.count) - result.successful;
+  }
+  if (const MetricSummary *s = statistics->metric(metrics::OffloadingType)) {
+    result.remote_count = static_cast<int>(std::lround(s->stats.sum));
+    result.local_count = static_cast<int>(s->stats.count) - result.remote_count;
   }
-  csv_file.close();
-
-  // Calculate stats
   if (result.total_tasks > 0) {
     result.success_rate =
         (double)result.successful / result.total_tasks * 100.0;
   }
-  if (!latencies.empty()) {
-    double sum = 0;
-    for (double l : latencies) sum += l;
-    result.avg_latency = sum / latencies.size();
+  if (const MetricSummary *s = statistics->metric(metrics::TaskLatency)) {
+    result.avg_latency = s->stats.mean();
+  }
+  double initial_battery = 10000.0;
+  double final_battery = initial_battery;
+  if (const MetricSummary *s = statistics->metric(metrics::BatteryRemaining)) {
+    final_battery = s->stats.last;
   }
   result.total_energy = initial_battery - final_battery;
 
@@ -179,6 +165,9 @@ PolicyResult run_with_policy(const std::string &policy_name,
 int main(int argc, char **argv) {
   int seed = 1978;
   bool chaos_mode = false;
+  bool show_stats = false;
+  std::string trace_file;  // all five runs, one after the other
+  bool binary_metrics = false;
 
   // Parse arguments
   for (int i = 1; i < argc; ++i) {
@@ -186,6 +175,13 @@ int main(int argc, char **argv) {
     if (arg == "--chaos") {
       chaos_mode = true;
       Config::set_chaos_mode();
+    } else if (arg == "--stats") {
+      show_stats = true;
+    } else if (arg == "--binary-metrics") {
+      binary_metrics = true;
+    } else if (arg.rfind("--trace=", 0) == 0) {
+      trace_file = arg.substr(8);
+      Tracer::enable();
     } else if (arg[0] != '-') {
       seed = std::stoi(arg);
     }
@@ -219,7 +215,7 @@ int main(int argc, char **argv) {
   cout << "Running Oracle..." << endl;
   auto oracle_result =
       run_with_policy("Oracle", std::make_shared<DeterministicPolicy>(),
-                      duration, seed, scenario_tasks);
+                      duration, seed, scenario_tasks, binary_metrics);
   results.push_back(oracle_result);
   cout << "  Success: " << oracle_result.successful << "/"
        << oracle_result.total_tasks << " (" << oracle_result.success_rate
@@ -227,8 +223,9 @@ int main(int argc, char **argv) {
 
   // Local
   cout << "Running Local..." << endl;
-  auto local_result = run_with_policy("Local", std::make_shared<OffPolicy>(),
-                                      duration, seed, scenario_tasks);
+  auto local_result =
+      run_with_policy("Local", std::make_shared<OffPolicy>(), duration, seed,
+                      scenario_tasks, binary_metrics);
   results.push_back(local_result);
   cout << "  Success: " << local_result.successful << "/"
        << local_result.total_tasks << " (" << local_result.success_rate << "%)"
@@ -238,7 +235,7 @@ int main(int argc, char **argv) {
   cout << "Running Random..." << endl;
   auto random_result =
       run_with_policy("Random", std::make_shared<RandomPolicy>(), duration,
-                      seed, scenario_tasks);
+                      seed, scenario_tasks, binary_metrics);
   results.push_back(random_result);
   cout << "  Success: " << random_result.successful << "/"
        << random_result.total_tasks << " (" << random_result.success_rate
@@ -248,7 +245,7 @@ int main(int argc, char **argv) {
   cout << "Running FirstRemote..." << endl;
   auto first_result =
       run_with_policy("FirstRemote", std::make_shared<FirstRemotePolicy>(),
-                      duration, seed, scenario_tasks);
+                      duration, seed, scenario_tasks, binary_metrics);
   results.push_back(first_result);
   cout << "  Success: " << first_result.successful << "/"
        << first_result.total_tasks << " (" << first_result.success_rate << "%)"
@@ -258,7 +255,7 @@ int main(int argc, char **argv) {
   cout << "Running Intelligent..." << endl;
   auto intel_result =
       run_with_policy("Intelligent", std::make_shared<IntelligentPolicy>(),
-                      duration, seed, scenario_tasks);
+                      duration, seed, scenario_tasks, binary_metrics);
   results.push_back(intel_result);
   cout << "  Success: " << intel_result.successful << "/"
        << intel_result.total_tasks << " (" << intel_result.success_rate << "%)"
@@ -289,6 +286,21 @@ int main(int argc, char **argv) {
 
   cout << "========================================" << endl;
 
+  if (show_stats) {
+    for (const auto &r : results) {
+      cout << r.name << " ";
+      r.engine.print(cout);
+    }
+    cout << "========================================" << endl;
+  }
+  if (!trace_file.empty()) {
+    if (!Tracer::write(trace_file)) {
+      cout << "Cannot write trace " << trace_file << endl;
+      return 1;
+    }
+    cout << "Trace written to " << trace_file << endl;
+  }
+
   // Write summary CSV
   std::ofstream summary("results/policy_comparison_summary.csv");
   summary << "Policy,TotalTasks,Successful,Failed,SuccessRate,AvgLatency,"
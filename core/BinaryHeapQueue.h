@@ -0,0 +1,36 @@
+#ifndef BINARYHEAPQUEUE_H
+#define BINARYHEAPQUEUE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "EventQueue.h"
+
+/**
+ * @brief Implicit binary heap over a contiguous vector
+ *
+ * Same algorithm as the former std::priority_queue FEL.
+ */
+class BinaryHeapQueue : public EventQueue {
+  std::vector<ScheduledEvent> heap;
+
+ public:
+  void push(ScheduledEvent ev) override {
+    heap.push_back(std::move(ev));
+    std::push_heap(heap.begin(), heap.end(), ScheduledEventLater{});
+  }
+
+  const ScheduledEvent &top() override { return heap.front(); }
+
+  ScheduledEvent pop() override {
+    std::pop_heap(heap.begin(), heap.end(), ScheduledEventLater{});
+    ScheduledEvent ev = std::move(heap.back());
+    heap.pop_back();
+    return ev;
+  }
+
+  bool empty() const override { return heap.empty(); }
+  size_t size() const override { return heap.size(); }
+};
+
+#endif  // BINARYHEAPQUEUE_H
@@ -0,0 +1,144 @@
+#include "CalendarQueue.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr size_t MIN_BUCKETS = 2;
+constexpr size_t WIDTH_SAMPLE = 25;
+}  // namespace
+
+CalendarQueue::CalendarQueue() : buckets(MIN_BUCKETS, NIL) {}
+
+uint32_t CalendarQueue::alloc_node(ScheduledEvent &&ev) {
+  uint32_t n;
+  if (free_list != NIL) {
+    n = free_list;
+    free_list = nodes[n].next;
+  } else {
+    n = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+  }
+  nodes[n].ev = std::move(ev);
+  nodes[n].next = NIL;
+  return n;
+}
+
+void CalendarQueue::free_node(uint32_t n) {
+  nodes[n].ev = ScheduledEvent{};
+  nodes[n].next = free_list;
+  free_list = n;
+}
+
+uint64_t CalendarQueue::day_of(double t) const {
+  return static_cast<uint64_t>(t / width);
+}
+
+void CalendarQueue::insert(uint32_t n) {
+  const ScheduledEvent &ev = nodes[n].ev;
+  uint32_t *link = &buckets[bucket_of(day_of(ev.time))];
+  // Keep each day sorted; equal keys stay in insertion order
+  while (*link != NIL && !ScheduledEventLater{}(nodes[*link].ev, ev)) {
+    link = &nodes[*link].next;
+  }
+  nodes[n].next = *link;
+  *link = n;
+}
+
+void CalendarQueue::push(ScheduledEvent ev) {
+  uint64_t day = day_of(ev.time);
+  uint32_t n = alloc_node(std::move(ev));
+  insert(n);
+  ++count;
+  if (day < last_day) last_day = day;
+  cached = false;
+  if (count > 2 * buckets.size()) resize(2 * buckets.size());
+}
+
+void CalendarQueue::locate_min() {
+  if (cached) return;
+  // Walk one "year" of days starting at the last served one
+  uint64_t day = last_day;
+  for (size_t k = 0; k < buckets.size(); ++k, ++day) {
+    uint32_t head = buckets[bucket_of(day)];
+    if (head != NIL && day_of(nodes[head].ev.time) <= day) {
+      cached_day = day;
+      cached = true;
+      return;
+    }
+  }
+  // Sparse calendar: jump straight to the earliest head
+  uint32_t best = NIL;
+  for (uint32_t head : buckets) {
+    if (head == NIL) continue;
+    if (best == NIL || ScheduledEventLater{}(nodes[best].ev, nodes[head].ev)) {
+      best = head;
+    }
+  }
+  cached_day = day_of(nodes[best].ev.time);
+  cached = true;
+}
+
+const ScheduledEvent &CalendarQueue::top() {
+  locate_min();
+  return nodes[buckets[bucket_of(cached_day)]].ev;
+}
+
+ScheduledEvent CalendarQueue::pop() {
+  locate_min();
+  uint32_t &head = buckets[bucket_of(cached_day)];
+  uint32_t n = head;
+  head = nodes[n].next;
+  ScheduledEvent ev = std::move(nodes[n].ev);
+  free_node(n);
+  --count;
+  last_day = cached_day;
+  cached = false;
+  if (buckets.size() > MIN_BUCKETS && count < buckets.size() / 2) {
+    resize(buckets.size() / 2);
+  }
+  return ev;
+}
+
+double CalendarQueue::estimate_width() {
+  // Brown's heuristic: three times the mean gap between the earliest events,
+  // ignoring gaps larger than twice the first estimate
+  samples.clear();
+  for (uint32_t head : buckets) {
+    for (uint32_t n = head; n != NIL; n = nodes[n].next) {
+      samples.push_back(nodes[n].ev.time);
+    }
+  }
+  size_t k = std::min(samples.size(), WIDTH_SAMPLE);
+  if (k < 2) return width;
+  std::partial_sort(samples.begin(), samples.begin() + k, samples.end());
+
+  double avg = (samples[k - 1] - samples[0]) / (k - 1);
+  double sum = 0.0;
+  size_t gaps = 0;
+  for (size_t i = 1; i < k; ++i) {
+    double gap = samples[i] - samples[i - 1];
+    if (gap <= 2.0 * avg) {
+      sum += gap;
+      ++gaps;
+    }
+  }
+  if (gaps == 0 || sum <= 0.0) return width;
+  return 3.0 * sum / gaps;
+}
+
+void CalendarQueue::resize(size_t new_buckets) {
+  double new_width = estimate_width();
+  double last_time = last_day * width;
+
+  scratch.clear();
+  for (uint32_t head : buckets) {
+    for (uint32_t n = head; n != NIL; n = nodes[n].next) scratch.push_back(n);
+  }
+  width = new_width;
+  buckets.assign(new_buckets, NIL);
+  for (uint32_t n : scratch) insert(n);
+
+  last_day = day_of(last_time);
+  cached = false;
+}
@@ -0,0 +1,62 @@
+#ifndef CALENDARQUEUE_H
+#define CALENDARQUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "EventQueue.h"
+
+/**
+ * @brief Calendar queue (R. Brown, CACM 1988)
+ *
+ * Events are hashed by time into a circular array of "day" buckets of a
+ * fixed width; each bucket is a time-sorted singly linked list. Dequeue walks
+ * the calendar from the last served day, so both operations are O(1)
+ * amortized when the bucket width matches the mean event spacing. The number
+ * of buckets doubles/halves with the population and the width is re-estimated
+ * from a sample of the earliest events on every resize.
+ *
+ * Entries live by value in a pooled node slab recycled through a free list,
+ * so steady-state operation performs no heap allocation.
+ */
+class CalendarQueue : public EventQueue {
+  static constexpr uint32_t NIL = UINT32_MAX;
+
+  struct Node {
+    ScheduledEvent ev;
+    uint32_t next = NIL;
+  };
+
+  std::vector<Node> nodes;           // slab of list nodes
+  uint32_t free_list = NIL;          // recycled nodes
+  std::vector<uint32_t> buckets;     // head node of each day
+  std::vector<uint32_t> scratch;     // reused while resizing
+  std::vector<double> samples;       // reused while estimating width
+  double width = 1.0;                // duration of one day
+  uint64_t last_day = 0;             // absolute day where the search resumes
+  size_t count = 0;
+
+  // Location of the current minimum, cached by top() and consumed by pop()
+  bool cached = false;
+  uint64_t cached_day = 0;
+
+  uint32_t alloc_node(ScheduledEvent &&ev);
+  void free_node(uint32_t n);
+  uint64_t day_of(double t) const;
+  size_t bucket_of(uint64_t day) const { return day & (buckets.size() - 1); }
+  void insert(uint32_t n);
+  void locate_min();
+  void resize(size_t new_buckets);
+  double estimate_width();
+
+ public:
+  CalendarQueue();
+
+  void push(ScheduledEvent ev) override;
+  const ScheduledEvent &top() override;
+  ScheduledEvent pop() override;
+  bool empty() const override { return count == 0; }
+  size_t size() const override { return count; }
+};
+
+#endif  // CALENDARQUEUE_H
@@ -12,10 +12,19 @@
  *
  * Where:
  *   - ρ ∈ (0,1) = memory/persistence coefficient (default: 0.9)
- *   - σ = chaos intensity (from Config::CHAOS_INTENSITY)
+ *   - σ = chaos intensity (from Config CHAOS_INTENSITY)
  *   - ε_t ~ U(-1, 1) = uniform noise
  *   - z_t = chaos state at time t
  *
+ * The run has one trajectory z_1, z_2, ...: step k takes ε_k from output
+ * pair k of a counter-based stream keyed by the seed alone, so z_k is a
+ * function of (seed, k). The state advances once per generated task; every
+ * task source (Model) reads the trajectory through its own cursor, start()ed
+ * from the run's manager, so its k-th task gets z_k however the entities'
+ * events interleave (or are partitioned in a parallel run). A task keeps
+ * the state it was created with, shared by all its parameters wherever it
+ * is processed.
+ *
  * Properties:
  *   ✔️ Temporal correlation (memory)
  *   ✔️ Mean zero (long-term)
@@ -24,9 +33,10 @@
  */
 
 #include <algorithm>
-#include <random>
+#include <cstdint>
 #include <vector>
 
+#include "../utils/Rng.h"
 #include "Config.h"
 
 class ChaosManager {
@@ -39,18 +49,27 @@ class ChaosManager {
   double z = 0.0;
 
   /**
-   * @brief Update the chaos state (call this at each event or fixed Δt)
+   * @brief Update the chaos state (call this once per generated task)
    *
    * Implements: z_t = ρ * z_{t-1} + σ * ε_t
    * where ε_t ~ U(-1, 1)
    */
   void update() {
-    std::uniform_real_distribution<double> noise_dist(-1.0, 1.0);
-    double epsilon = noise_dist(chaos_engine_);
-    z = RHO * z + Config::CHAOS_INTENSITY * epsilon;
+    ++step_;
+    double epsilon =
+        2.0 * Rng::unit(noise_.at(2 * step_), noise_.at(2 * step_ + 1)) - 1.0;
+    z = RHO * z + Config::get().CHAOS_INTENSITY * epsilon;
     z_history_.push_back(z);
   }
 
+  // Cursor at the start of the run's trajectory
+  ChaosManager start() const {
+    ChaosManager cursor;
+    cursor.key_ = key_;
+    cursor.noise_.seed(key_);
+    return cursor;
+  }
+
   /**
    * @brief Apply chaos drift to a base value
    *
@@ -82,26 +101,79 @@ class ChaosManager {
    */
   void reset() {
     z = 0.0;
+    step_ = 0;
     z_history_.clear();
   }
 
+  // State needed to undo update() calls (optimistic parallel rollback)
+  struct Checkpoint {
+    double z = 0.0;
+    uint64_t step = 0;
+    uint32_t key = 0;
+    Philox4x32 noise{};
+    size_t history = 0;
+  };
+
+  Checkpoint checkpoint() const {
+    return {z, step_, key_, noise_, z_history_.size()};
+  }
+
+  void restore(const Checkpoint &c) {
+    z = c.z;
+    step_ = c.step;
+    key_ = c.key;
+    noise_ = c.noise;
+    z_history_.resize(c.history);
+  }
+
+  // Snapshot restore, possibly into another manager: the whole history
+  void restore(const Checkpoint &c, const std::vector<double> &history) {
+    z = c.z;
+    step_ = c.step;
+    key_ = c.key;
+    noise_ = c.noise;
+    z_history_ = history;
+  }
+
   /**
-   * @brief Seed the internal chaos RNG for reproducibility
+   * @brief Seed the chaos noise for reproducibility
    * @param seed The random seed
    */
-  void seed(int s) { chaos_engine_.seed(s); }
+  void seed(int s) {
+    key_ = static_cast<uint32_t>(s);
+    noise_.seed(key_);
+  }
 
-  // Singleton access
+  // Singleton access (the entity's cursor while it draws, or SimContext
+  // while one is bound)
   static ChaosManager &instance() {
     static ChaosManager manager;
-    return manager;
+    ChaosManager *b = bound();
+    return b ? *b : manager;
+  }
+
+  // Returns the previous binding of the calling thread
+  static ChaosManager *bind(ChaosManager *manager) {
+    ChaosManager *previous = bound();
+    bound() = manager;
+    return previous;
   }
 
  private:
-  ChaosManager() : chaos_engine_(42) {}
+  friend class SimContext;
+  friend class Model;
+
+  ChaosManager() : key_(42), noise_(key_) {}
+
+  static ChaosManager *&bound() {
+    static thread_local ChaosManager *manager = nullptr;
+    return manager;
+  }
 
-  // Internal RNG engine (separate from main simulation RNG)
-  std::mt19937 chaos_engine_;
+  // Noise stream (separate from the simulation streams), read by step
+  uint32_t key_;  // seed
+  Philox4x32 noise_;
+  uint64_t step_ = 0;
 
   // History of chaos states for validation
   std::vector<double> z_history_;
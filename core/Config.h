@@ -2,40 +2,81 @@
 
 namespace Config {
 
-// --------------------------------------------------
-// Chaos Mode
-// --------------------------------------------------
+/**
+ * @brief Scenario parameters of one simulation run
+ *
+ * Config::get() returns the parameters of the SimContext bound to the
+ * calling thread, or the process-wide defaults() edited by the command-line
+ * tools when none is bound.
+ */
+struct Parameters {
+  // --------------------------------------------------
+  // Chaos Mode
+  // --------------------------------------------------
 
-inline bool FIELD_TOTAL_CHAOS = false;
+  bool FIELD_TOTAL_CHAOS = false;
 
-// --------------------------------------------------
-// Chaos Intensity (temporal amplification)
-// --------------------------------------------------
-inline double CHAOS_INTENSITY = 1.0;  // default: no amplification
+  // --------------------------------------------------
+  // Chaos Intensity (temporal amplification)
+  // --------------------------------------------------
+  double CHAOS_INTENSITY = 1.0;  // default: no amplification
+
+  void set_chaos_mode() {
+    FIELD_TOTAL_CHAOS = true;
+    CHAOS_INTENSITY = 1.5;  // moderate chaos (was 2.5, reduced for stability)
+  }
+
+  // --------------------------------------------------
+  // Traffic Generation
+  // --------------------------------------------------
+  // Lambda = Arrival Rate (tasks per second)
+  // 1 task every 0.4s => 2.5 tasks/s
+  double TRAFFIC_LAMBDA = 1.0 / 0.4;
+
+  // --------------------------------------------------
+  // Network
+  // --------------------------------------------------
+  // Propagation delay before an offloaded task reaches its RSU (seconds).
+  // 0 keeps the synchronous hand-off; parallel runs need > 0 (lookahead).
+  double UPLINK_LATENCY = 0.0;
+
+  // --------------------------------------------------
+  // Task Characteristics
+  // --------------------------------------------------
+  long TASK_MIN_SIZE = 100000;
+  long TASK_MAX_SIZE = 300000;
+
+  long TASK_MEAN_DENSITY = 1000;
+  long TASK_STD_DENSITY = 100;
 
-inline void set_chaos_mode() {
-  FIELD_TOTAL_CHAOS = true;
-  CHAOS_INTENSITY = 1.5;  // moderate chaos (was 2.5, reduced for stability)
+  double TASK_MIN_DEADLINE = 0.4;
+  double TASK_MAX_DEADLINE = 0.5;
+};
+
+inline Parameters &defaults() {
+  static Parameters parameters;
+  return parameters;
 }
 
-// --------------------------------------------------
-// Traffic Generation
-// --------------------------------------------------
-// Lambda = Arrival Rate (tasks per second)
-// 1 task every 0.4s => 2.5 tasks/s
-inline double TRAFFIC_LAMBDA = 1.0 / 0.4;
+inline Parameters *&bound() {
+  static thread_local Parameters *parameters = nullptr;
+  return parameters;
+}
 
-// --------------------------------------------------
-// Task Characteristics
-// --------------------------------------------------
-inline long TASK_MIN_SIZE = 100000;
-inline long TASK_MAX_SIZE = 300000;
+// Routes get() of the calling thread to `parameters` (nullptr: defaults());
+// returns the previous binding
+inline Parameters *bind(Parameters *parameters) {
+  Parameters *previous = bound();
+  bound() = parameters;
+  return previous;
+}
 
-inline long TASK_MEAN_DENSITY = 1000;
-inline long TASK_STD_DENSITY = 100;
+inline Parameters &get() {
+  Parameters *p = bound();
+  return p ? *p : defaults();
+}
 
-inline double TASK_MIN_DEADLINE = 0.4;
-inline double TASK_MAX_DEADLINE = 0.5;
+inline void set_chaos_mode() { get().set_chaos_mode(); }
 
 // --------------------------------------------------
 // Uncertainty Reference Bounds (FIXED DESIGN SPACE)
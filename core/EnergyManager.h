@@ -4,7 +4,6 @@
 #include <cmath>
 
 #include "../utils/Rng.h"
-#include "ChaosManager.h"
 #include "Config.h"
 
 class EnergyManager {
@@ -12,10 +11,11 @@ class EnergyManager {
   // Constants for energy model
   static constexpr double K = 1e-28;  // Effective switched capacitance
 
-  static double calculate_processing_energy(double frequency, long cycles) {
+  // `drift`: chaos state of the task (Task::get_drift())
+  static double calculate_processing_energy(double frequency, long cycles,
+                                            double drift) {
     double result = K * std::pow(frequency, 2) * cycles;
-    if (Config::FIELD_TOTAL_CHAOS) {
-      double drift = ChaosManager::instance().get_state();
+    if (Config::get().FIELD_TOTAL_CHAOS) {
       return Rng::pdrift(result, drift);
     }
     return result;
@@ -23,11 +23,10 @@ class EnergyManager {
 
   // Placeholder for future transmission energy logic
   static double calculate_transmission_energy(double size_bytes,
-                                              double distance) {
+                                              double distance, double drift) {
     // Linear model: 5.0 Joules per MB (High Tx power for long range)
     double result = 5.0 * size_bytes / 1e6;
-    if (Config::FIELD_TOTAL_CHAOS) {
-      double drift = ChaosManager::instance().get_state();
+    if (Config::get().FIELD_TOTAL_CHAOS) {
       return Rng::pdrift(result, drift);
     }
     return result;
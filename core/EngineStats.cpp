@@ -0,0 +1,39 @@
+#include "EngineStats.h"
+
+#include <iomanip>
+#include <ostream>
+
+double EngineStats::estimated_seconds(EventType type) const {
+  size_t t = static_cast<size_t>(type);
+  if (timed[t] == 0) return 0.0;
+  return timed_seconds[t] / timed[t] * by_type[t];
+}
+
+void EngineStats::print(std::ostream &out) const {
+  std::ios::fmtflags flags = out.flags();
+  std::streamsize precision = out.precision();
+  out << std::fixed << std::setprecision(3) << "Engine: " << dispatched
+      << " events in " << wall_seconds << " s (" << std::setprecision(0)
+      << events_per_second() << " events/s)\n"
+      << "  scheduled " << scheduled << ", rescheduled " << rescheduled
+      << ", cancelled " << cancelled << ", stale entries skipped " << skipped
+      << "\n"
+      << std::setprecision(2) << "  pending events: peak " << peak_pending
+      << ", time-average " << mean_pending() << "\n"
+      << "  " << std::left << std::setw(22) << "Event type" << std::right
+      << std::setw(12) << "Count" << std::setw(9) << "Share"
+      << std::setw(13) << "Est. wall(s)" << std::setw(11) << "us/event"
+      << "\n";
+  for (size_t t = 0; t < TYPES; ++t) {
+    if (by_type[t] == 0) continue;
+    EventType type = static_cast<EventType>(t);
+    double seconds = estimated_seconds(type);
+    out << "  " << std::left << std::setw(22) << event_type_name(type)
+        << std::right << std::setw(12) << by_type[t] << std::setw(8)
+        << std::setprecision(1) << 100.0 * by_type[t] / dispatched << "%"
+        << std::setw(13) << std::setprecision(3) << seconds << std::setw(11)
+        << std::setprecision(2) << 1e6 * seconds / by_type[t] << "\n";
+  }
+  out.flags(flags);
+  out.precision(precision);
+}
@@ -1,29 +1,32 @@
 #ifndef EVENT_H
 #define EVENT_H
 
-#include <memory>
-#include <vector>
-
+class EventPool;
+class Model;
 class Simulator;
+class SnapshotReader;
+class SnapshotWriter;
 
 class Event {
+  friend class Simulator;  // updates time on reschedule
+
  protected:
   double time = 0.0;
 
  public:
-  using PtrEvent = std::shared_ptr<Event>;
-  using VecPtrEvent = std::vector<PtrEvent>;
   Event(double time_) : time(time_) {}
   virtual ~Event() = default;
   double get_time() const { return time; }
   virtual void execute(Simulator &sim) = 0;
+  // Entity whose state execute() mutates, saved by the optimistic parallel
+  // engine; nullptr makes it save every entity of the partition
+  virtual Model *subject() const { return nullptr; }
+  // Snapshot support: the tag of the loader registered with
+  // Snapshot::register_event and the fields it reads back (time aside).
+  // Events without a tag make Snapshot::capture() throw while pending.
+  virtual const char *snapshot_tag() const { return nullptr; }
+  virtual void write_snapshot(SnapshotWriter & /*out*/) const {}
   bool operator>(const Event &other) const { return time > other.time; }
 };
 
-struct EventPtrComparator {
-  bool operator()(const Event::PtrEvent &lhs, const Event::PtrEvent &rhs) {
-    return *lhs > *rhs;
-  }
-};
-
 #endif  // EVENT_H
@@ -0,0 +1,106 @@
+#ifndef EVENTPOOL_H
+#define EVENTPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Event.h"
+
+/**
+ * @brief Counters of the event pool, readable after Simulator::run()
+ */
+struct EventPoolStats {
+  size_t live = 0;      // events constructed and not yet recycled
+  size_t peak = 0;      // maximum of live over the run
+  size_t created = 0;   // total events constructed
+  size_t capacity = 0;  // slots carved from slabs (all size classes)
+};
+
+/**
+ * @brief Slab allocator with per-size-class free lists for Event subclasses
+ *
+ * Each slot has a small header recording its size class, so destroy() works
+ * from the Event pointer alone. Slots are recycled LIFO (cache-warm) and
+ * slabs are only released with the pool, hence steady-state scheduling does
+ * no heap allocation.
+ */
+class EventPool {
+  static constexpr size_t GRANULE = alignof(std::max_align_t);
+  static constexpr size_t SLAB_SLOTS = 256;
+
+  struct alignas(GRANULE) Header {
+    size_t size_class;
+  };
+
+  struct FreeSlot {
+    FreeSlot *next;
+  };
+
+  std::vector<FreeSlot *> free_lists;  // indexed by size class
+  std::vector<std::unique_ptr<std::byte[]>> slabs;
+  EventPoolStats stats;
+
+  static size_t slot_bytes(size_t size_class) {
+    return sizeof(Header) + size_class * GRANULE;
+  }
+
+  void grow(size_t size_class) {
+    size_t bytes = slot_bytes(size_class);
+    slabs.emplace_back(new std::byte[bytes * SLAB_SLOTS]);
+    std::byte *base = slabs.back().get();
+    for (size_t i = SLAB_SLOTS; i-- > 0;) {
+      auto *slot = reinterpret_cast<FreeSlot *>(base + i * bytes);
+      slot->next = free_lists[size_class];
+      free_lists[size_class] = slot;
+    }
+    stats.capacity += SLAB_SLOTS;
+  }
+
+  void *acquire(size_t size_class) {
+    if (size_class >= free_lists.size()) free_lists.resize(size_class + 1);
+    if (!free_lists[size_class]) grow(size_class);
+    FreeSlot *slot = free_lists[size_class];
+    free_lists[size_class] = slot->next;
+
+    auto *header = reinterpret_cast<Header *>(slot);
+    header->size_class = size_class;
+    return reinterpret_cast<std::byte *>(slot) + sizeof(Header);
+  }
+
+ public:
+  EventPool() = default;
+  EventPool(const EventPool &) = delete;
+  EventPool &operator=(const EventPool &) = delete;
+
+  template <typename T, typename... Args>
+  T *create(Args &&...args) {
+    static_assert(std::is_base_of_v<Event, T>, "T must derive from Event");
+    static_assert(alignof(T) <= GRANULE, "over-aligned events unsupported");
+    constexpr size_t size_class = (sizeof(T) + GRANULE - 1) / GRANULE;
+    void *mem = acquire(size_class);
+    T *event = new (mem) T(std::forward<Args>(args)...);
+    ++stats.created;
+    if (++stats.live > stats.peak) stats.peak = stats.live;
+    return event;
+  }
+
+  void destroy(Event *event) {
+    // Most-derived address, i.e. where create() placed the object
+    auto *mem = static_cast<std::byte *>(dynamic_cast<void *>(event));
+    event->~Event();
+    auto *header = reinterpret_cast<Header *>(mem - sizeof(Header));
+    size_t size_class = header->size_class;
+    auto *slot = reinterpret_cast<FreeSlot *>(header);
+    slot->next = free_lists[size_class];
+    free_lists[size_class] = slot;
+    --stats.live;
+  }
+
+  const EventPoolStats &get_stats() const { return stats; }
+};
+
+#endif  // EVENTPOOL_H
@@ -0,0 +1,45 @@
+#include "EventQueue.h"
+
+#include "BinaryHeapQueue.h"
+#include "CalendarQueue.h"
+#include "RadixQueue.h"
+
+std::unique_ptr<EventQueue> make_event_queue(QueueKind kind) {
+  switch (kind) {
+    case QueueKind::Calendar:
+      return std::make_unique<CalendarQueue>();
+    case QueueKind::Radix:
+      return std::make_unique<RadixQueue>();
+    case QueueKind::BinaryHeap:
+    default:
+      return std::make_unique<BinaryHeapQueue>();
+  }
+}
+
+const char *queue_kind_name(QueueKind kind) {
+  switch (kind) {
+    case QueueKind::Calendar:
+      return "calendar";
+    case QueueKind::Radix:
+      return "radix";
+    case QueueKind::BinaryHeap:
+    default:
+      return "heap";
+  }
+}
+
+bool parse_queue_kind(const std::string &name, QueueKind &kind) {
+  if (name == "heap") {
+    kind = QueueKind::BinaryHeap;
+    return true;
+  }
+  if (name == "calendar") {
+    kind = QueueKind::Calendar;
+    return true;
+  }
+  if (name == "radix") {
+    kind = QueueKind::Radix;
+    return true;
+  }
+  return false;
+}
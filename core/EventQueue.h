@@ -0,0 +1,74 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Event.h"
+#include "EventType.h"
+
+/**
+ * @brief Entry stored by value in the future event list (FEL)
+ *
+ * Model events are a compact (time, target, type) record dispatched through
+ * event_handlers; only EventType::Custom carries a polymorphic Event, owned
+ * by the Simulator's EventPool. seq is a monotonic schedule counter that
+ * breaks timestamp ties in FIFO order. (slot, generation) identify the entry
+ * for cancellation: entries whose generation is outdated are skipped lazily.
+ */
+struct ScheduledEvent {
+  double time = 0.0;
+  uint64_t seq = 0;
+  Model *target = nullptr;
+  EventType type = EventType::Custom;
+  uint32_t slot = 0;
+  uint32_t generation = 0;
+  Event *event = nullptr;
+};
+
+/**
+ * @brief Strict total order used by every FEL backend ("a fires after b")
+ *
+ * Ties on time are broken by seq, so all backends dispatch events in exactly
+ * the same order and runs are reproducible across queue implementations.
+ */
+struct ScheduledEventLater {
+  bool operator()(const ScheduledEvent &a, const ScheduledEvent &b) const {
+    if (a.time != b.time) return a.time > b.time;
+    return a.seq > b.seq;
+  }
+};
+
+/**
+ * @brief Available future event list implementations
+ *
+ * - BinaryHeap: std::push_heap/pop_heap over a vector, O(log n)
+ * - Calendar:   Brown's calendar queue over pooled nodes, O(1) amortized
+ * - Radix:      radix heap over monotone time keys, O(1) push, O(log C)
+ *               amortized pop
+ */
+enum class QueueKind { BinaryHeap, Calendar, Radix };
+
+/**
+ * @brief Future event list interface used by Simulator
+ *
+ * top() must be called on a non-empty queue; pop() removes the entry
+ * returned by the last top() (or the earliest one).
+ */
+class EventQueue {
+ public:
+  virtual ~EventQueue() = default;
+  virtual void push(ScheduledEvent ev) = 0;
+  virtual const ScheduledEvent &top() = 0;
+  virtual ScheduledEvent pop() = 0;
+  virtual bool empty() const = 0;
+  virtual size_t size() const = 0;
+};
+
+std::unique_ptr<EventQueue> make_event_queue(QueueKind kind);
+const char *queue_kind_name(QueueKind kind);
+bool parse_queue_kind(const std::string &name, QueueKind &kind);
+
+#endif  // EVENTQUEUE_H
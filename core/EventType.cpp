@@ -0,0 +1,29 @@
+#include "EventType.h"
+
+#include <stdexcept>
+
+EventHandler event_handlers[EVENT_TYPE_COUNT] = {};
+
+bool register_event_handler(EventType type, EventHandler handler) {
+  if (type == EventType::Custom) {
+    throw std::invalid_argument("Custom events dispatch through Event");
+  }
+  event_handlers[static_cast<size_t>(type)] = handler;
+  return true;
+}
+
+const char *event_type_name(EventType type) {
+  switch (type) {
+    case EventType::OnDecisionStart:
+      return "OnDecisionStart";
+    case EventType::OnDecisionComplete:
+      return "OnDecisionComplete";
+    case EventType::OnProcessingStart:
+      return "OnProcessingStart";
+    case EventType::OnProcessingComplete:
+      return "OnProcessingComplete";
+    case EventType::Custom:
+      return "Custom";
+  }
+  return "?";
+}
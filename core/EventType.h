@@ -0,0 +1,30 @@
+#ifndef EVENTTYPE_H
+#define EVENTTYPE_H
+
+#include <cstddef>
+
+class Model;
+class Simulator;
+
+enum class EventType {
+  OnDecisionStart,
+  OnDecisionComplete,
+  OnProcessingStart,
+  OnProcessingComplete,
+  Custom,  // Polymorphic Event payload (TaskGenerationEvent, ...)
+};
+
+// Model events are dispatched through a static jump table indexed by
+// EventType instead of per-instance std::function maps. The engine owns the
+// table; the model layer fills it at start-up (model/EventHandlers.cpp).
+using EventHandler = void (*)(Model &, Simulator &);
+constexpr size_t EVENT_TYPE_COUNT = static_cast<size_t>(EventType::Custom);
+extern EventHandler event_handlers[EVENT_TYPE_COUNT];
+
+// Installs the handler of a model event type; returns true so it can
+// initialize a namespace-scope constant
+bool register_event_handler(EventType type, EventHandler handler);
+
+const char *event_type_name(EventType type);
+
+#endif  // EVENTTYPE_H
@@ -0,0 +1,447 @@
+#include "ParallelSimulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "../model/Model.h"
+#include "EventType.h"
+#include "SimContext.h"
+#include "Tracer.h"
+
+namespace {
+
+constexpr uint64_t REMOTE_SEQ = Simulator::REMOTE_SEQ;
+
+}  // namespace
+
+ParallelSimulator::ParallelSimulator(size_t partitions, double lookahead_,
+                                     QueueKind kind, SyncMode mode_)
+    : context(SimContext::current()), lookahead(lookahead_), mode(mode_) {
+  if (partitions == 0) {
+    throw std::invalid_argument("ParallelSimulator needs >= 1 partition");
+  }
+  if (mode == SyncMode::Conservative && partitions > 1 && lookahead <= 0.0) {
+    throw std::invalid_argument(
+        "ParallelSimulator needs a positive lookahead "
+        "(set Config::get().UPLINK_LATENCY)");
+  }
+  for (size_t i = 0; i < partitions; ++i) {
+    lps.push_back(std::make_unique<LogicalProcess>(kind));
+    lps.back()->sim->attach(this, i);
+  }
+}
+
+ParallelSimulator::~ParallelSimulator() { stop_workers(); }
+
+void ParallelSimulator::set_optimism(double horizon) {
+  if (horizon <= 0.0) {
+    throw std::invalid_argument("ParallelSimulator: optimism must be > 0");
+  }
+  optimism = horizon;
+}
+
+void ParallelSimulator::set_resolution(double seconds) {
+  for (auto &lp : lps) lp->sim->set_resolution(seconds);
+  if (seconds <= 0.0 || lookahead <= 0.0) return;
+  // Arrivals snap to whole ticks at least floor(lookahead) ticks ahead; the
+  // half-tick margin absorbs rounding in the tick -> seconds conversions,
+  // and windows cut between grid points bound the same events
+  double ticks = std::floor(lookahead / seconds);
+  if (ticks < 1.0 && mode == SyncMode::Conservative && lps.size() > 1) {
+    throw std::invalid_argument(
+        "ParallelSimulator: lookahead shorter than one tick");
+  }
+  lookahead = ticks < 1.0 ? 0.0 : (ticks - 0.5) * seconds;
+}
+
+void ParallelSimulator::assign(Model &model, size_t index) {
+  if (index >= lps.size()) {
+    throw std::out_of_range("ParallelSimulator::assign: no partition " +
+                            std::to_string(index));
+  }
+  model.set_partition(index);
+  lps[index]->models.push_back(&model);
+}
+
+void ParallelSimulator::send(size_t from, size_t to, double t, uint64_t key,
+                             RemoteDelivery deliver) {
+  LogicalProcess &src = *lps[from];
+  Simulator &sender = *src.sim;
+  if (mode == SyncMode::Optimistic) {
+    // Through the inbox even within a partition, so that anti-messages
+    // retract it on rollback
+    src.sent.push_back({sender.now(), sender.executed, to, t, key});
+    if (to != from) ++src.counters.messages;
+    mail(*lps[to], {t, from, to, std::move(deliver), key, false});
+    return;
+  }
+  if (to == from) {
+    sender.deliver_remote(deliver, t, key);
+    return;
+  }
+  if (t < sender.now() + lookahead) {
+    throw std::runtime_error(
+        "ParallelSimulator: cross-partition message violates lookahead");
+  }
+  src.outbox.push_back({t, from, to, std::move(deliver), key});
+}
+
+void ParallelSimulator::run(double end_time, size_t threads) {
+  SimContext::Scope scope(context);
+  threads = std::max<size_t>(1, std::min(threads, lps.size()));
+  start_workers(threads - 1);
+
+  if (mode == SyncMode::Optimistic) {
+    run_optimistic(end_time);
+  } else {
+    run_conservative(end_time);
+  }
+
+  stop_workers();
+  stats.events = 0;
+  for (auto &lp : lps) {
+    stats.events += lp->sim->events_executed();
+    stats.messages += lp->counters.messages;
+    stats.rollbacks += lp->counters.rollbacks;
+    stats.rolled_back += lp->counters.rolled_back;
+    stats.anti_messages += lp->counters.anti_messages;
+    lp->counters = Stats();
+  }
+}
+
+void ParallelSimulator::run_conservative(double end_time) {
+  while (true) {
+    double t_min = std::numeric_limits<double>::infinity();
+    for (auto &lp : lps) t_min = std::min(t_min, lp->sim->next_time());
+    if (t_min > end_time) break;
+
+    window_bound = t_min + lookahead;
+    window_end = end_time;
+    // A single partition needs no lookahead: one window covers the run
+    final_window = lookahead <= 0.0 || window_bound > end_time;
+    execute_window();
+    {
+      TraceSpan span("barrier");
+      deliver_messages();
+      flush_metrics();
+    }
+    ++stats.windows;
+    if (final_window) break;
+  }
+}
+
+void ParallelSimulator::execute(LogicalProcess &lp) {
+  TraceSpan span("partition", static_cast<int>(lp.sim->partition));
+  // Context first (partitions run on pool threads), then the metric buffer
+  SimContext::Scope scope(context);
+  std::vector<MetricRecord> *metrics = MetricsHub::bind_buffer(&lp.metrics);
+  if (mode == SyncMode::Optimistic) {
+    std::vector<LogRecord> *logs = Logger::bind_buffer(&lp.logs);
+    speculate(lp);
+    Logger::bind_buffer(logs);
+  } else if (final_window) {
+    lp.sim->run(window_end);
+  } else {
+    lp.sim->run_until(window_bound, window_end);
+  }
+  MetricsHub::bind_buffer(metrics);
+}
+
+void ParallelSimulator::execute_window() {
+  next_lp.store(0);
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    finished = 0;
+    ++generation;
+  }
+  start_cv.notify_all();
+
+  for (size_t i; (i = next_lp.fetch_add(1)) < lps.size();) execute(*lps[i]);
+
+  std::unique_lock<std::mutex> lock(mtx);
+  done_cv.wait(lock, [this] { return finished == workers.size(); });
+}
+
+void ParallelSimulator::worker_loop() {
+  uint64_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      start_cv.wait(lock, [&] { return stopping || generation != seen; });
+      if (stopping) return;
+      seen = generation;
+    }
+    for (size_t i; (i = next_lp.fetch_add(1)) < lps.size();) execute(*lps[i]);
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      ++finished;
+    }
+    done_cv.notify_one();
+  }
+}
+
+void ParallelSimulator::start_workers(size_t count) {
+  stopping = false;
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    generation = 0;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    workers.emplace_back(&ParallelSimulator::worker_loop, this);
+  }
+}
+
+void ParallelSimulator::stop_workers() {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+  }
+  start_cv.notify_all();
+  for (auto &w : workers) w.join();
+  workers.clear();
+}
+
+void ParallelSimulator::deliver_messages() {
+  // Delivery order does not matter: keys order arrivals at equal time
+  for (auto &lp : lps) {
+    for (const Message &m : lp->outbox) {
+      lps[m.to]->sim->deliver_remote(m.deliver, m.time, m.id);
+    }
+    stats.messages += lp->outbox.size();
+    lp->outbox.clear();
+  }
+}
+
+void ParallelSimulator::flush_metrics() {
+  std::vector<MetricRecord> batch;
+  for (auto &lp : lps) {
+    for (auto &rec : lp->metrics) batch.push_back(std::move(rec));
+    lp->metrics.clear();
+  }
+  std::stable_sort(batch.begin(), batch.end(),
+                   [](const MetricRecord &a, const MetricRecord &b) {
+                     return a.time < b.time;
+                   });
+  for (const auto &rec : batch) MetricsHub::instance().dispatch(rec);
+}
+
+void ParallelSimulator::run_optimistic(double end_time) {
+  for (auto &lp : lps) {
+    lp->sim->disable_bypass();
+    lp->sim->end_time = end_time;
+    lp->sim->undo_state = true;
+    if (lp->sim->state) lp->sim->state->set_undo(true);
+  }
+  while (true) {
+    double gvt;
+    {
+      TraceSpan span("gvt");
+      gvt = drain_and_compute_gvt();
+      commit(gvt);
+    }
+    if (gvt > end_time) break;
+    window_bound = std::min(gvt + optimism, end_time);
+    execute_window();
+    ++stats.windows;
+  }
+}
+
+void ParallelSimulator::speculate(LogicalProcess &lp) {
+  Simulator &sim = *lp.sim;
+  ScheduledEvent ev;
+  while (true) {
+    if (lp.has_mail.load(std::memory_order_acquire)) receive(lp);
+    if (!sim.next_event(window_bound, true, ev)) break;
+    if (!sim.is_live(ev)) {
+      --sim.stale;
+      continue;
+    }
+    save(lp, ev);
+    // The slot and payload stay reserved until the event is committed
+    sim.slots[ev.slot].in_use = false;
+    sim.current_time = ev.time;
+    ++sim.executed;
+    if (ev.type == EventType::Custom) {
+      ev.event->execute(sim);
+    } else {
+      event_handlers[static_cast<size_t>(ev.type)](*ev.target, sim);
+    }
+  }
+}
+
+void ParallelSimulator::save(LogicalProcess &lp, const ScheduledEvent &ev) {
+  const Simulator &sim = *lp.sim;
+  lp.processed.push_back({ev, sim.current_time, sim.next_seq, sim.executed,
+                          lp.committed_metrics + lp.metrics.size(),
+                          lp.committed_logs + lp.logs.size(),
+                          sim.state ? sim.state->mark() : 0, nullptr, nullptr,
+                          {}});
+  Processed &p = lp.processed.back();
+  p.subject = ev.type == EventType::Custom ? ev.event->subject() : ev.target;
+  if (p.subject) {
+    p.state = p.subject->save_state();
+  } else {
+    for (Model *m : lp.models) p.all.push_back(m->save_state());
+  }
+}
+
+void ParallelSimulator::mail(LogicalProcess &lp, Message m) {
+  std::lock_guard<std::mutex> lock(lp.inbox_mtx);
+  lp.inbox.push_back(std::move(m));
+  lp.has_mail.store(true, std::memory_order_release);
+}
+
+void ParallelSimulator::receive(LogicalProcess &lp) {
+  {
+    std::lock_guard<std::mutex> lock(lp.inbox_mtx);
+    lp.mail.swap(lp.inbox);
+    lp.has_mail.store(false, std::memory_order_relaxed);
+  }
+  Simulator &sim = *lp.sim;
+  // A sender's messages arrive in send order, so an anti-message always
+  // follows its positive message
+  for (Message &m : lp.mail) {
+    uint64_t seq = REMOTE_SEQ | m.id;
+    if (m.anti) {
+      auto it = lp.received.find(m.id);
+      if (it == lp.received.end()) {
+        throw std::logic_error("ParallelSimulator: unmatched anti-message");
+      }
+      EventHandle handle = it->second;
+      lp.received.erase(it);
+      const Simulator::Slot &slot = sim.slots[handle.slot];
+      if (!slot.in_use && slot.generation == handle.generation) {
+        rollback(lp, m.time, seq);  // already executed: undo it too
+      }
+      sim.cancel(handle);
+      continue;
+    }
+    rollback(lp, m.time, seq);  // no-op unless it is a straggler
+    lp.received[m.id] = sim.deliver_remote(m.deliver, m.time, m.id);
+  }
+  lp.mail.clear();
+}
+
+void ParallelSimulator::rollback(LogicalProcess &lp, double t, uint64_t seq) {
+  // Find the first executed event ordered at or after (t, seq). Execution
+  // order is not sorted by seq: a zero-delay event scheduled by a remote one
+  // has a smaller seq than its parent
+  size_t first = lp.processed.size();
+  for (size_t i = lp.processed.size(); i-- > 0;) {
+    const ScheduledEvent &ev = lp.processed[i].ev;
+    if (ev.time < t) break;
+    if (ev.time > t || ev.seq >= seq) first = i;
+  }
+  if (first == lp.processed.size()) return;
+
+  Simulator &sim = *lp.sim;
+  TraceSpan span("rollback", static_cast<int>(sim.partition));
+  ++lp.counters.rollbacks;
+  // Undo it and everything executed after it, latest first
+  while (lp.processed.size() > first) {
+    Processed &p = lp.processed.back();
+    if (sim.state) sim.state->undo(p.run_mark);
+    if (p.subject) {
+      p.subject->restore_state(*p.state);
+    } else {
+      for (size_t i = 0; i < lp.models.size(); ++i) {
+        lp.models[i]->restore_state(*p.all[i]);
+      }
+    }
+    lp.metrics.erase(lp.metrics.begin() + (p.metrics - lp.committed_metrics),
+                     lp.metrics.end());
+    auto undone = lp.logs.begin() + (p.logs - lp.committed_logs);
+    for (auto it = undone; it != lp.logs.end(); ++it) it->release();
+    lp.logs.erase(undone, lp.logs.end());
+    sim.current_time = p.prev_time;
+    sim.next_seq = p.prev_seq;
+    sim.executed = p.prev_executed;
+    sim.slots[p.ev.slot].in_use = true;
+    sim.fel->push(p.ev);
+    lp.processed.pop_back();
+    ++lp.counters.rolled_back;
+  }
+  // Events scheduled by the undone ones carry the sequence numbers handed
+  // out since; re-execution schedules them again
+  for (uint32_t i = 0; i < sim.slots.size(); ++i) {
+    const Simulator::Slot &slot = sim.slots[i];
+    if (slot.in_use && slot.seq >= sim.next_seq && !(slot.seq & REMOTE_SEQ)) {
+      sim.cancel({i, slot.generation});
+    }
+  }
+  // Retract what they sent
+  while (!lp.sent.empty() && lp.sent.back().executed > sim.executed) {
+    const Sent &s = lp.sent.back();
+    mail(*lps[s.to], {s.time, sim.partition, s.to, nullptr, s.id, true});
+    ++lp.counters.anti_messages;
+    lp.sent.pop_back();
+  }
+}
+
+double ParallelSimulator::drain_and_compute_gvt() {
+  // Rollbacks may emit anti-messages; loop until no message is in transit
+  bool pending = true;
+  while (pending) {
+    pending = false;
+    for (auto &lp : lps) {
+      if (lp->has_mail.load(std::memory_order_acquire)) {
+        receive(*lp);
+        pending = true;
+      }
+    }
+  }
+  double gvt = std::numeric_limits<double>::infinity();
+  for (auto &lp : lps) gvt = std::min(gvt, lp->sim->next_time());
+  return gvt;
+}
+
+void ParallelSimulator::commit(double gvt) {
+  std::vector<MetricRecord> batch;
+  std::vector<LogRecord> lines;
+  for (auto &lp : lps) {
+    Simulator &sim = *lp->sim;
+    while (!lp->processed.empty() && lp->processed.front().ev.time < gvt) {
+      const ScheduledEvent &ev = lp->processed.front().ev;
+      if (ev.seq & REMOTE_SEQ) lp->received.erase(ev.seq & ~REMOTE_SEQ);
+      if (ev.event) sim.pool.destroy(ev.event);
+      sim.release(ev.slot);
+      lp->processed.pop_front();
+    }
+    if (sim.state) {
+      sim.state->forget(lp->processed.empty() ? sim.state->mark()
+                                              : lp->processed.front().run_mark);
+    }
+    while (!lp->sent.empty() && lp->sent.front().send_time < gvt) {
+      lp->sent.pop_front();
+    }
+    // Each partition's records are in time order
+    auto cut = std::partition_point(
+        lp->metrics.begin(), lp->metrics.end(),
+        [gvt](const MetricRecord &rec) { return rec.time < gvt; });
+    for (auto it = lp->metrics.begin(); it != cut; ++it) {
+      batch.push_back(std::move(*it));
+    }
+    lp->committed_metrics += cut - lp->metrics.begin();
+    lp->metrics.erase(lp->metrics.begin(), cut);
+    auto line_cut = std::partition_point(
+        lp->logs.begin(), lp->logs.end(),
+        [gvt](const LogRecord &record) { return record.time < gvt; });
+    lines.insert(lines.end(), lp->logs.begin(), line_cut);
+    lp->committed_logs += line_cut - lp->logs.begin();
+    lp->logs.erase(lp->logs.begin(), line_cut);
+  }
+  std::stable_sort(batch.begin(), batch.end(),
+                   [](const MetricRecord &a, const MetricRecord &b) {
+                     return a.time < b.time;
+                   });
+  for (const auto &rec : batch) MetricsHub::instance().dispatch(rec);
+  std::stable_sort(lines.begin(), lines.end(),
+                   [](const LogRecord &a, const LogRecord &b) {
+                     return a.time < b.time;
+                   });
+  // The writer thread releases their texts
+  for (const auto &record : lines) Logger::instance().write(record);
+}
@@ -0,0 +1,202 @@
+#ifndef PARALLELSIMULATOR_H
+#define PARALLELSIMULATOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../logger.h"
+#include "../metric.h"
+#include "../model/Model.h"
+#include "Config.h"
+#include "Simulator.h"
+
+enum class SyncMode { Conservative, Optimistic };
+
+/**
+ * @brief Parallel engine over partitions of the model
+ *
+ * Model entities are partitioned into logical processes (LPs), each one a
+ * full Simulator with its own FEL. Entities of different partitions only
+ * interact through Simulator::post().
+ *
+ * Conservative mode (window-based / YAWNS): the arrival time of a post()
+ * must be at least `lookahead` after the sender's clock
+ * (Config UPLINK_LATENCY for the Vehicle -> RSU offload). Hence, with T the
+ * earliest pending event of all partitions, every event in [T, T +
+ * lookahead) is safe and partitions execute that window concurrently. At the
+ * barrier, cross-partition messages are delivered and buffered metrics are
+ * forwarded to MetricsHub listeners sorted by time.
+ *
+ * Optimistic mode (Time Warp): partitions execute speculatively up to
+ * `optimism` seconds past GVT, saving the state of each event's subject
+ * (Event::subject(), the target Model for compact events). A message
+ * arriving in a partition's past (straggler) rolls it back; events it had
+ * scheduled are cancelled and anti-messages retract what it had sent. GVT
+ * is taken at round barriers; events, metrics and trace lines below it are
+ * committed, so rolled-back events leave no trace.
+ *
+ * Results are those of a plain Simulator run with the same Config and
+ * seed, for any number of partitions and threads. Nothing an event
+ * computes depends on the partitioning: entities draw from their own
+ * streams and chaos cursor and number their own tasks (Model::DrawScope,
+ * Model::next_task_id()), and posted arrivals are ordered by their key
+ * after local events at equal time, as in a sequential run. This requires
+ * that entities interact only through post() (the Vehicle model does so
+ * when UPLINK_LATENCY > 0; with 0 it hands tasks over synchronously and
+ * throws if a hand-off crosses partitions), that no entity is created while
+ * running and that vehicles placed in different partitions do not share an
+ * OffPolicy instance (policies keep busy/idle state). Records of different
+ * partitions with equal timestamps may reach the listeners in another
+ * order than in the sequential run; the records themselves are the same.
+ *
+ * The SimContext current at construction (if any) supplies the seeds the
+ * entities derive their streams from and receives the metrics.
+ */
+class ParallelSimulator {
+ public:
+  struct Stats {
+    uint64_t windows = 0;
+    uint64_t messages = 0;
+    uint64_t events = 0;
+    // Optimistic mode
+    uint64_t rollbacks = 0;
+    uint64_t rolled_back = 0;  // events undone
+    uint64_t anti_messages = 0;
+  };
+
+  ParallelSimulator(size_t partitions,
+                    double lookahead = Config::get().UPLINK_LATENCY,
+                    QueueKind kind = QueueKind::BinaryHeap,
+                    SyncMode mode = SyncMode::Conservative);
+  ~ParallelSimulator();
+  ParallelSimulator(const ParallelSimulator &) = delete;
+  ParallelSimulator &operator=(const ParallelSimulator &) = delete;
+
+  size_t partitions() const { return lps.size(); }
+  Simulator &partition(size_t index) { return *lps[index]->sim; }
+  double get_lookahead() const { return lookahead; }
+  SyncMode get_mode() const { return mode; }
+  // Optimistic mode: how far past GVT partitions may speculate per round
+  void set_optimism(double horizon);
+  // Integer time base of every partition (Simulator::set_resolution)
+  void set_resolution(double seconds);
+
+  // Places an entity; schedule its initial events on partition(index)
+  void assign(Model &model, size_t index);
+
+  void run(double end_time, size_t threads = 1);
+
+  const Stats &get_stats() const { return stats; }
+
+  // Called by Simulator::post() for interactions of partition entities
+  void send(size_t from, size_t to, double t, uint64_t key,
+            RemoteDelivery deliver);
+
+ private:
+  struct Message {
+    double time;
+    size_t from;
+    size_t to;
+    RemoteDelivery deliver;
+    uint64_t id = 0;  // post() key
+    bool anti = false;
+  };
+
+  // Optimistic mode: an executed event, kept until GVT passes it
+  struct Processed {
+    ScheduledEvent ev;
+    double prev_time;
+    uint64_t prev_seq;
+    uint64_t prev_executed;
+    size_t metrics;  // records emitted before it, committed ones included
+    size_t logs;     // trace records, likewise
+    uint64_t run_mark;  // run state mark before it
+    Model *subject;
+    std::unique_ptr<ModelState> state;
+    std::vector<std::unique_ptr<ModelState>> all;  // when subject is null
+  };
+
+  // Optimistic mode: a sent message, retracted if its sender rolls back
+  struct Sent {
+    double send_time;
+    uint64_t executed;  // sender's event count when sent
+    size_t to;
+    double time;
+    uint64_t id;
+  };
+
+  struct LogicalProcess {
+    std::unique_ptr<Simulator> sim;
+    std::vector<MetricRecord> metrics;
+    std::vector<Message> outbox;
+
+    // Optimistic mode
+    std::vector<Model *> models;
+    std::deque<Processed> processed;
+    std::deque<Sent> sent;
+    std::unordered_map<uint64_t, EventHandle> received;  // by message id
+    size_t committed_metrics = 0;
+    std::vector<LogRecord> logs;
+    size_t committed_logs = 0;
+    std::mutex inbox_mtx;
+    std::vector<Message> inbox;
+    std::vector<Message> mail;
+    std::atomic<bool> has_mail{false};
+    Stats counters;  // rollbacks, rolled_back, anti_messages, messages
+
+    explicit LogicalProcess(QueueKind kind)
+        : sim(std::make_unique<Simulator>(kind)) {}
+    ~LogicalProcess() {
+      for (LogRecord &record : logs) record.release();
+    }
+  };
+
+  SimContext *context;
+  std::vector<std::unique_ptr<LogicalProcess>> lps;
+  double lookahead;
+  SyncMode mode;
+  double optimism = 0.1;
+  Stats stats;
+
+  // Window being executed by the workers
+  double window_bound = 0.0;
+  double window_end = 0.0;
+  bool final_window = false;
+  std::atomic<size_t> next_lp{0};
+
+  // Worker pool
+  std::vector<std::thread> workers;
+  std::mutex mtx;
+  std::condition_variable start_cv;
+  std::condition_variable done_cv;
+  uint64_t generation = 0;
+  size_t finished = 0;
+  bool stopping = false;
+
+  void start_workers(size_t count);
+  void stop_workers();
+  void worker_loop();
+  void run_conservative(double end_time);
+  void execute_window();
+  void execute(LogicalProcess &lp);
+  void deliver_messages();
+  void flush_metrics();
+
+  // Optimistic mode
+  void run_optimistic(double end_time);
+  void speculate(LogicalProcess &lp);
+  void save(LogicalProcess &lp, const ScheduledEvent &ev);
+  void mail(LogicalProcess &lp, Message m);
+  void receive(LogicalProcess &lp);
+  void rollback(LogicalProcess &lp, double t, uint64_t seq);
+  double drain_and_compute_gvt();
+  void commit(double gvt);
+};
+
+#endif  // PARALLELSIMULATOR_H
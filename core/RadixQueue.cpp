@@ -0,0 +1,94 @@
+#include "RadixQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Bucket 0 order: equal keys, so seq alone decides
+struct SeqLater {
+  bool operator()(const ScheduledEvent &a, const ScheduledEvent &b) const {
+    return a.seq > b.seq;
+  }
+};
+}  // namespace
+
+uint64_t RadixQueue::key_of(double t) {
+  t += 0.0;  // -0.0 -> +0.0
+  uint64_t key;
+  std::memcpy(&key, &t, sizeof key);
+  return key;
+}
+
+size_t RadixQueue::bucket_of(uint64_t key, uint64_t last) {
+  return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+}
+
+void RadixQueue::push(ScheduledEvent ev) {
+  // A new earliest entry outdates the cached location
+  if (cached && ScheduledEventLater{}(locate_min(), ev)) cached = false;
+  uint64_t key = key_of(ev.time);
+  if (count == 0) last = key;  // an empty heap may restart anywhere
+  if (key < last) {
+    early.push_back(std::move(ev));
+    std::push_heap(early.begin(), early.end(), ScheduledEventLater{});
+  } else {
+    size_t b = bucket_of(key, last);
+    buckets[b].push_back(std::move(ev));
+    if (b == 0) {
+      std::push_heap(buckets[0].begin(), buckets[0].end(), SeqLater{});
+    }
+  }
+  ++count;
+}
+
+const ScheduledEvent &RadixQueue::locate_min() {
+  if (!cached) {
+    cached = true;
+    cached_index = 0;
+    if (!early.empty()) {
+      cached_bucket = BUCKETS;
+    } else {
+      cached_bucket = 0;
+      while (buckets[cached_bucket].empty()) ++cached_bucket;
+      const std::vector<ScheduledEvent> &b = buckets[cached_bucket];
+      if (cached_bucket > 0) {
+        for (size_t i = 1; i < b.size(); ++i) {
+          if (ScheduledEventLater{}(b[cached_index], b[i])) cached_index = i;
+        }
+      }
+    }
+  }
+  if (cached_bucket == BUCKETS) return early.front();
+  return buckets[cached_bucket][cached_index];
+}
+
+ScheduledEvent RadixQueue::pop() {
+  locate_min();
+  cached = false;
+  --count;
+  if (cached_bucket == BUCKETS) {
+    std::pop_heap(early.begin(), early.end(), ScheduledEventLater{});
+    ScheduledEvent ev = std::move(early.back());
+    early.pop_back();
+    return ev;
+  }
+  std::vector<ScheduledEvent> &b = buckets[cached_bucket];
+  if (cached_bucket == 0) {
+    std::pop_heap(b.begin(), b.end(), SeqLater{});
+    ScheduledEvent ev = std::move(b.back());
+    b.pop_back();
+    return ev;
+  }
+  ScheduledEvent ev = std::move(b[cached_index]);
+  b[cached_index] = std::move(b.back());
+  b.pop_back();
+  // Every other key in the bucket lands strictly lower for the new last;
+  // bucket 0 was empty, so it is heapified once at the end
+  last = key_of(ev.time);
+  for (ScheduledEvent &e : b) {
+    buckets[bucket_of(key_of(e.time), last)].push_back(std::move(e));
+  }
+  b.clear();
+  std::make_heap(buckets[0].begin(), buckets[0].end(), SeqLater{});
+  return ev;
+}
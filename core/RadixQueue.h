@@ -0,0 +1,50 @@
+#ifndef RADIXQUEUE_H
+#define RADIXQUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "EventQueue.h"
+
+/**
+ * @brief Radix heap (Ahuja, Mehlhorn, Orlin & Tarjan, JACM 1990)
+ *
+ * Exploits that the FEL is monotone: no event is scheduled before the last
+ * one served. Keys are the IEEE-754 bit patterns of the (non-negative)
+ * times, which order like the times themselves, so this works on integer
+ * ticks and on continuous time alike. Bucket i holds the keys whose highest
+ * bit differing from `last` (the last served key) is bit i - 1; bucket 0
+ * holds key == last as a min-heap by seq. Serving from bucket i > 0 makes
+ * its minimum the new `last` and spreads the rest over lower buckets, so an
+ * entry moves at most 64 times over its life and push is O(1).
+ *
+ * Entries before `last` (re-inserted by an optimistic rollback) wait in a
+ * small binary heap and are always served first.
+ */
+class RadixQueue : public EventQueue {
+  static constexpr size_t BUCKETS = 65;
+
+  std::array<std::vector<ScheduledEvent>, BUCKETS> buckets;
+  std::vector<ScheduledEvent> early;  // keys below last, ScheduledEventLater
+  uint64_t last = 0;
+  size_t count = 0;
+
+  // Location of the current minimum, cached by top() and consumed by pop()
+  bool cached = false;
+  size_t cached_bucket = 0;
+  size_t cached_index = 0;
+
+  static uint64_t key_of(double t);
+  static size_t bucket_of(uint64_t key, uint64_t last);
+  const ScheduledEvent &locate_min();
+
+ public:
+  void push(ScheduledEvent ev) override;
+  const ScheduledEvent &top() override { return locate_min(); }
+  ScheduledEvent pop() override;
+  bool empty() const override { return count == 0; }
+  size_t size() const override { return count; }
+};
+
+#endif  // RADIXQUEUE_H
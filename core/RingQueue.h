@@ -0,0 +1,49 @@
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief FIFO over a power-of-two circular buffer
+ *
+ * Unlike std::deque it keeps its storage between push/pop cycles, so a
+ * queue that has reached its working size never allocates again.
+ */
+template <typename T>
+class RingQueue {
+  std::vector<T> data = std::vector<T>(16);
+  size_t head = 0;
+  size_t count = 0;
+
+  void grow() {
+    std::vector<T> bigger(data.size() * 2);
+    for (size_t i = 0; i < count; ++i) {
+      bigger[i] = std::move(data[(head + i) & (data.size() - 1)]);
+    }
+    data.swap(bigger);
+    head = 0;
+  }
+
+ public:
+  void push(T value) {
+    if (count == data.size()) grow();
+    data[(head + count) & (data.size() - 1)] = std::move(value);
+    ++count;
+  }
+
+  T &front() { return data[head]; }
+
+  T pop() {
+    T value = std::move(data[head]);
+    head = (head + 1) & (data.size() - 1);
+    --count;
+    return value;
+  }
+
+  bool empty() const { return count == 0; }
+  size_t size() const { return count; }
+};
+
+#endif  // RINGQUEUE_H
@@ -0,0 +1,32 @@
+#ifndef RUNSTATE_H
+#define RUNSTATE_H
+
+#include <cstdint>
+
+class SnapshotReader;
+class SnapshotWriter;
+
+/**
+ * @brief Model-owned state of one run, opaque to the engine
+ *
+ * A Simulator holds at most one, installed by the model layer on first use
+ * (the task records, see TaskStore). The engine only rolls it back in
+ * optimistic partitions and carries it through snapshots.
+ */
+class RunState {
+ public:
+  virtual ~RunState() = default;
+
+  // Log changes so that undo() can revert them
+  virtual void set_undo(bool enable) = 0;
+  virtual uint64_t mark() const = 0;
+  // Reverts every change logged since `m`
+  virtual void undo(uint64_t m) = 0;
+  // Drops log entries before `m`
+  virtual void forget(uint64_t m) = 0;
+
+  virtual void write_snapshot(SnapshotWriter &out) const = 0;
+  virtual void read_snapshot(SnapshotReader &in) = 0;
+};
+
+#endif  // RUNSTATE_H
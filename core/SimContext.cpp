@@ -0,0 +1,64 @@
+#include "SimContext.h"
+
+#include <algorithm>
+
+#include "../utils/WorkStealingPool.h"
+
+namespace {
+
+SimContext *&bound() {
+  static thread_local SimContext *context = nullptr;
+  return context;
+}
+
+}  // namespace
+
+SimContext::SimContext(int seed, const Config::Parameters &parameters,
+                       const std::string &trace_path)
+    : config(parameters),
+      rng(static_cast<uint32_t>(seed)),
+      logger(trace_path) {
+  chaos.seed(seed);
+}
+
+SimContext *SimContext::current() { return bound(); }
+
+SimContext::Scope::Scope(SimContext *context) {
+  if (!context || context == bound()) return;
+  active = true;
+  previous = bound();
+  bound() = context;
+  config = Config::bind(&context->config);
+  rng = Rng::bind(&context->rng);
+  chaos = ChaosManager::bind(&context->chaos);
+  ids = IdManager::bind(&context->ids);
+  workload = Workload::bind(&context->workload);
+  metrics = MetricsHub::bind(&context->metrics);
+  logger = Logger::bind(&context->logger);
+}
+
+SimContext::Scope::~Scope() {
+  if (!active) return;
+  Logger::bind(logger);
+  MetricsHub::bind(metrics);
+  Workload::bind(workload);
+  IdManager::bind(ids);
+  ChaosManager::bind(chaos);
+  Rng::bind(rng);
+  Config::bind(config);
+  bound() = previous;
+}
+
+void run_replicas(const std::vector<std::unique_ptr<SimContext>> &contexts,
+                  const std::function<void(SimContext &, size_t)> &body,
+                  size_t threads) {
+  size_t workers = std::max<size_t>(1, std::min(threads, contexts.size()));
+  WorkStealingPool pool(workers);
+  for (size_t i = 0; i < contexts.size(); ++i) {
+    pool.submit([&contexts, &body, i] {
+      SimContext::Scope scope(contexts[i].get());
+      body(*contexts[i], i);
+    });
+  }
+  pool.wait();
+}
@@ -0,0 +1,92 @@
+#ifndef SIMCONTEXT_H
+#define SIMCONTEXT_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../logger.h"
+#include "../metric.h"
+#include "../utils/IdManager.h"
+#include "../utils/Rng.h"
+#include "../utils/Workload.h"
+#include "ChaosManager.h"
+#include "Config.h"
+
+/**
+ * @brief State of one simulation replica
+ *
+ * Owns what the model otherwise reaches through process-wide singletons:
+ * configuration, RNG streams, chaos process, entity id sequence, workload
+ * blocks, metrics hub and trace logger. While a Scope binds a context to a
+ * thread, Config::get(), Rng, ChaosManager::instance(), IdManager,
+ * Workload::instance(), MetricsHub::instance() and Logger::instance()
+ * resolve to its members on that thread, so models and policies need no
+ * changes to run as independent replicas concurrently.
+ *
+ * A Simulator (or ParallelSimulator) remembers the context current when it
+ * was constructed and binds it again whenever it runs, on any thread.
+ */
+class SimContext {
+ public:
+  // Seeds rng and chaos with `seed` as main() does for the global streams;
+  // an empty trace_path disables trace logging
+  explicit SimContext(int seed,
+                      const Config::Parameters &parameters = Config::defaults(),
+                      const std::string &trace_path = "");
+  SimContext(const SimContext &) = delete;
+  SimContext &operator=(const SimContext &) = delete;
+
+  Config::Parameters config;
+  Rng::Streams rng;
+  ChaosManager chaos;
+  IdManager::Stream ids{1};
+  Workload workload;
+  MetricsHub metrics;
+  Logger logger;
+
+  // Context bound to the calling thread, nullptr when none
+  static SimContext *current();
+
+  /**
+   * @brief Binds a context to the calling thread for its lifetime
+   *
+   * Restores the previous bindings on destruction. No-op for nullptr or the
+   * context already current.
+   */
+  class Scope {
+   public:
+    explicit Scope(SimContext *context);
+    ~Scope();
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   private:
+    SimContext *previous = nullptr;
+    bool active = false;
+    Config::Parameters *config = nullptr;
+    Rng::Streams *rng = nullptr;
+    ChaosManager *chaos = nullptr;
+    IdManager::Stream *ids = nullptr;
+    Workload *workload = nullptr;
+    MetricsHub *metrics = nullptr;
+    Logger *logger = nullptr;
+  };
+};
+
+/**
+ * @brief Runs body(*contexts[i], i) for every replica on up to `threads`
+ * threads
+ *
+ * Each call is bound to its context for its whole duration, so a replica
+ * produces bit-identical results whether replicas run concurrently or one at
+ * a time. Rethrows the first exception after all threads have joined.
+ */
+void run_replicas(const std::vector<std::unique_ptr<SimContext>> &contexts,
+                  const std::function<void(SimContext &, size_t)> &body,
+                  size_t threads = std::thread::hardware_concurrency());
+
+#endif  // SIMCONTEXT_H
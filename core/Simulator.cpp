@@ -1,23 +1,300 @@
 #include "Simulator.h"
 
-void Simulator::schedule(Event::PtrEvent event) {
-  if (event->get_time() < current_time) {
+#include <algorithm>
+#include <chrono>
+
+#include "ParallelSimulator.h"
+#include "SimContext.h"
+#include "Tracer.h"
+
+Simulator::Simulator(QueueKind kind)
+    : fel(make_event_queue(kind)),
+      queue_kind(kind),
+      context(SimContext::current()) {
+  wheel.set_granularity(micro_step);
+}
+
+Simulator::~Simulator() {
+  // Events left past the end time still own pooled payloads
+  discard_pending();
+}
+
+void Simulator::discard_pending() {
+  auto discard = [this](const ScheduledEvent &ev) {
+    if (is_live(ev) && ev.event) pool.destroy(ev.event);
+  };
+  while (!immediate.empty()) discard(immediate.pop());
+  while (!fel->empty()) discard(fel->pop());
+  while (!wheel.empty()) discard(wheel.pop());
+  slots.clear();
+  free_slots.clear();
+  stale = 0;
+}
+
+std::vector<ScheduledEvent> Simulator::collect_pending() {
+  std::vector<ScheduledEvent> pending;
+  auto keep = [&](const ScheduledEvent &ev) {
+    if (is_live(ev)) pending.push_back(ev);
+  };
+  while (!immediate.empty()) keep(immediate.pop());
+  while (!fel->empty()) keep(fel->pop());
+  while (!wheel.empty()) keep(wheel.pop());
+  stale = 0;
+  std::sort(pending.begin(), pending.end(),
+            [](const ScheduledEvent &a, const ScheduledEvent &b) {
+              return ScheduledEventLater{}(b, a);
+            });
+  // Zero-delay entries may leave the ring: (time, seq) orders them anyway
+  for (const ScheduledEvent &ev : pending) {
+    if (!wheel.offer(ev, current_time)) fel->push(ev);
+  }
+  return pending;
+}
+
+void Simulator::check_causality(double t) const {
+  if (t < current_time) {
     std::cerr << "ERROR: Temporal causality violation!\n"
-              << "  Trying to schedule event at t=" << event->get_time()
+              << "  Trying to schedule event at t=" << t
               << " but current_time=" << current_time << "\n"
-              << "  Delta: " << (event->get_time() - current_time) << "\n";
+              << "  Delta: " << (t - current_time) << "\n";
     throw std::runtime_error("Cannot schedule event in the past");
   }
-  fel.push(event);
+}
+
+void Simulator::set_resolution(double seconds) {
+  if (!(seconds >= 0.0) || std::isinf(seconds)) {
+    throw std::invalid_argument("Simulator: invalid time resolution");
+  }
+  if (next_seq != 0) {
+    throw std::logic_error(
+        "Simulator: set the time resolution before scheduling events");
+  }
+  resolution = seconds;
+}
+
+EventHandle Simulator::enqueue(double t, Model *target, EventType type,
+                               Event *event) {
+  uint32_t slot;
+  if (!free_slots.empty()) {
+    slot = free_slots.back();
+    free_slots.pop_back();
+  } else {
+    slot = static_cast<uint32_t>(slots.size());
+    slots.emplace_back();
+  }
+  ++stats.scheduled;
+  if (live_events() > stats.peak_pending) stats.peak_pending = live_events();
+  Slot &s = slots[slot];
+  s.in_use = true;
+  s.type = type;
+  s.target = target;
+  s.event = event;
+  push({t, 0, target, type, slot, s.generation, event});
+  return {slot, s.generation};
+}
+
+void Simulator::push(ScheduledEvent ev) {
+  ev.seq = next_seq++;
+  slots[ev.slot].seq = ev.seq;
+  // The ring is FIFO, so only local sequence numbers may enter it
+  if (bypass && ev.time == current_time && !(ev.seq & REMOTE_SEQ)) {
+    immediate.push(ev);
+  } else if (!wheel.offer(ev, current_time)) {
+    fel->push(ev);
+  }
+}
+
+const ScheduledEvent *Simulator::peek(bool &in_wheel) {
+  const ScheduledEvent *queued = fel->empty() ? nullptr : &fel->top();
+  const ScheduledEvent *near = wheel.empty() ? nullptr : &wheel.top();
+  in_wheel = near && (!queued || ScheduledEventLater{}(*queued, *near));
+  return in_wheel ? near : queued;
+}
+
+bool Simulator::next_event(double bound, bool inclusive, ScheduledEvent &ev) {
+  bool in_wheel;
+  const ScheduledEvent *head = peek(in_wheel);
+  // FEL entries at the current time were scheduled before any zero-delay
+  // event, hence go first, except remote arrivals of a parallel run, which
+  // carry larger sequence numbers
+  if (!immediate.empty() &&
+      (!head || head->time > current_time ||
+       head->seq > immediate.front().seq)) {
+    ev = immediate.pop();
+    return true;
+  }
+  if (!head) return false;
+  double t = head->time;
+  if (inclusive ? t > bound : t >= bound) return false;
+  ev = in_wheel ? wheel.pop() : fel->pop();
+  return true;
+}
+
+void Simulator::release(uint32_t slot) {
+  Slot &s = slots[slot];
+  ++s.generation;  // outdates the handle and any FEL entry
+  s.in_use = false;
+  s.target = nullptr;
+  s.event = nullptr;
+  free_slots.push_back(slot);
+}
+
+void Simulator::disable_bypass() {
+  bypass = false;
+  while (!immediate.empty()) fel->push(immediate.pop());
+}
+
+EventHandle Simulator::schedule(double t, Model &target, EventType type) {
+  t = snap(t);
+  check_causality(t);
+  return enqueue(t, &target, type, nullptr);
+}
+
+bool Simulator::is_pending(EventHandle handle) const {
+  return handle.valid() && handle.slot < slots.size() &&
+         slots[handle.slot].in_use &&
+         slots[handle.slot].generation == handle.generation;
+}
+
+bool Simulator::cancel(EventHandle handle) {
+  if (!is_pending(handle)) return false;
+  Event *event = slots[handle.slot].event;
+  release(handle.slot);
+  if (event) pool.destroy(event);
+  ++stale;
+  ++stats.cancelled;
+  return true;
+}
+
+EventHandle Simulator::reschedule(EventHandle handle, double t) {
+  if (!is_pending(handle)) return {};
+  t = snap(t);
+  check_causality(t);
+  // Keep the slot and payload, outdate the old entry and push a new one
+  Slot &s = slots[handle.slot];
+  ++s.generation;
+  ++stale;
+  ++stats.rescheduled;
+  if (s.event) s.event->time = t;
+  push({t, 0, s.target, s.type, handle.slot, s.generation, s.event});
+  return {handle.slot, s.generation};
+}
+
+double Simulator::next_time() {
+  if (!immediate.empty()) return current_time;
+  // Drop cancelled entries so the bound reflects a live event
+  bool in_wheel;
+  while (const ScheduledEvent *head = peek(in_wheel)) {
+    if (is_live(*head)) return head->time;
+    if (in_wheel) {
+      wheel.pop();
+    } else {
+      fel->pop();
+    }
+    --stale;
+  }
+  return std::numeric_limits<double>::infinity();
+}
+
+EventHandle Simulator::deliver_remote(const RemoteDelivery &deliver,
+                                      double t, uint64_t key) {
+  uint64_t local = next_seq;
+  next_seq = REMOTE_SEQ | key;
+  EventHandle handle = deliver(*this, t);
+  next_seq = local;
+  return handle;
+}
+
+void Simulator::post(size_t target_partition, double t, uint64_t key,
+                     RemoteDelivery deliver) {
+  t = snap(t);
+  check_causality(t);
+  if (key >= REMOTE_SEQ) {
+    throw std::out_of_range("Simulator::post: key out of range");
+  }
+  if (!parallel) {
+    deliver_remote(deliver, t, key);
+    return;
+  }
+  parallel->send(partition, target_partition, t, key, std::move(deliver));
 }
 
 void Simulator::run(double sim_end_time) {
+  TraceSpan span("run", parallel ? static_cast<int>(partition) : -1);
+  SimContext::Scope scope(context);
+  end_time = sim_end_time;
+  advance(sim_end_time, true);
+}
+
+void Simulator::run_until(double bound, double sim_end_time) {
+  TraceSpan span("window", parallel ? static_cast<int>(partition) : -1);
+  SimContext::Scope scope(context);
   end_time = sim_end_time;
-  while (!fel.empty()) {
-    Event::PtrEvent event = fel.top();
-    fel.pop();
-    if (event->get_time() > sim_end_time) break;
-    current_time = event->get_time();
-    event->execute(*this);
+  advance(bound, false);
+}
+
+void Simulator::advance(double bound, bool inclusive) {
+  using Clock = std::chrono::steady_clock;
+  auto seconds = [](Clock::time_point since) {
+    return std::chrono::duration<double>(Clock::now() - since).count();
+  };
+  Clock::time_point started = Clock::now();
+  const bool tracing = Tracer::enabled();
+  ScheduledEvent next;
+  while (next_event(bound, inclusive, next)) {
+    if (!is_live(next)) {
+      --stale;
+      ++stats.skipped;
+      continue;
+    }
+    // Pending count over [current_time, next.time), this event included
+    double dt = next.time - current_time;
+    stats.pending_area += dt * live_events();
+    stats.span += dt;
+    release(next.slot);
+    current_time = next.time;
+    ++executed;
+    size_t type = static_cast<size_t>(next.type);
+    ++stats.by_type[type];
+    bool timed = ++stats.dispatched % EngineStats::TIMING_SAMPLE == 0;
+    Clock::time_point dispatch_start;
+    if (timed) dispatch_start = Clock::now();
+    if (tracing) {
+      dispatch_traced(next);
+    } else {
+      dispatch(next);
+    }
+    if (timed) {
+      ++stats.timed[type];
+      stats.timed_seconds[type] += seconds(dispatch_start);
+    }
   }
+  stats.wall_seconds += seconds(started);
+}
+
+void Simulator::dispatch(const ScheduledEvent &ev) {
+  if (ev.type == EventType::Custom) {
+    ev.event->execute(*this);
+    pool.destroy(ev.event);
+  } else {
+    event_handlers[static_cast<size_t>(ev.type)](*ev.target, *this);
+  }
+}
+
+void Simulator::dispatch_traced(const ScheduledEvent &ev) {
+  // Custom events are named by their snapshot tag when they have one
+  bool custom = ev.type == EventType::Custom;
+  const Model *entity = custom ? ev.event->subject() : ev.target;
+  const char *type = event_type_name(ev.type);
+  const char *tag = custom ? ev.event->snapshot_tag() : nullptr;
+  Tracer::Span span{tag ? tag : type,
+                    "event",
+                    type,
+                    entity ? entity->get_id() : -1,
+                    parallel ? static_cast<int>(partition) : -1,
+                    Tracer::now_ns(),
+                    0};
+  dispatch(ev);
+  span.duration_ns = Tracer::now_ns() - span.start_ns;
+  Tracer::record(span);
 }
@@ -1,35 +1,219 @@
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include <cmath>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <iostream>
-#include <memory> /* for shared_ptr, make_shared */
-#include <queue>
+#include <limits>
+#include <memory> /* for unique_ptr */
 #include <stdexcept>
 #include <vector>
 
+#include "EngineStats.h"
 #include "Event.h"
+#include "EventPool.h"
+#include "EventQueue.h"
+#include "RingQueue.h"
+#include "RunState.h"
+#include "TimingWheel.h"
 
 const double micro_step = 0.0001;
 
+/**
+ * @brief Lightweight reference to a scheduled event
+ *
+ * Becomes stale once the event fires or is cancelled; stale handles are
+ * safely ignored by cancel()/reschedule().
+ */
+struct EventHandle {
+  static constexpr uint32_t NONE = UINT32_MAX;
+  uint32_t slot = NONE;
+  uint32_t generation = 0;
+  bool valid() const { return slot != NONE; }
+};
+
+class ParallelSimulator;
+class SimContext;
+
+/**
+ * @brief Delivery of a posted interaction
+ *
+ * Invoked on the destination partition's Simulator (immediately on the
+ * sender's in a sequential run) with the arrival time; it schedules exactly
+ * one event there and returns its handle.
+ */
+using RemoteDelivery = std::function<EventHandle(Simulator &, double)>;
+
 class Simulator {
-  std::priority_queue<Event::PtrEvent, Event::VecPtrEvent, EventPtrComparator>
-      fel;
+  friend class ParallelSimulator;  // partition driver (and rollback)
+  friend class Snapshot;
+
+  // Bookkeeping of one scheduled event, reused through free_slots
+  struct Slot {
+    uint32_t generation = 0;
+    bool in_use = false;
+    uint64_t seq = 0;  // of the live FEL entry
+    EventType type = EventType::Custom;
+    Model *target = nullptr;
+    Event *event = nullptr;
+  };
+
+  EventPool pool;
+  std::unique_ptr<EventQueue> fel;
+  // Zero-delay events (time == now) bypass the FEL: their FIFO order is the
+  // (time, seq) order, and next_event() merges them with FEL entries at the
+  // current time by seq
+  RingQueue<ScheduledEvent> immediate;
+  // Near-future events (the micro_step hops of every task, short service
+  // times) skip the FEL too; next_event() merges both in (time, seq) order
+  TimingWheel wheel;
+  QueueKind queue_kind;
+  bool bypass = true;  // route zero-delay events through `immediate`
+  uint64_t next_seq = 0;
+  std::vector<Slot> slots;
+  std::vector<uint32_t> free_slots;
+  size_t stale = 0;  // cancelled entries still sitting in the FEL
   double current_time = 0.0;
   double end_time = 0.0;
+  double resolution = 0.0;  // seconds per tick, 0: continuous time
+  uint64_t executed = 0;
+  EngineStats stats;
+
+  // Context current at construction, bound again while running
+  SimContext *context = nullptr;
+
+  // Model-owned, see set_run_state(); logs undo in optimistic partitions
+  std::unique_ptr<RunState> state;
+  bool undo_state = false;
+
+  // Set when this Simulator is one partition of a ParallelSimulator
+  ParallelSimulator *parallel = nullptr;
+  size_t partition = 0;
+
+  void check_causality(double t) const;
+  // Schedules a posted arrival with sequence number REMOTE_SEQ | key
+  EventHandle deliver_remote(const RemoteDelivery &deliver, double t,
+                             uint64_t key);
+  EventHandle enqueue(double t, Model *target, EventType type, Event *event);
+  void push(ScheduledEvent ev);
+  // Earliest entry of the FEL and the wheel, nullptr when both are empty
+  const ScheduledEvent *peek(bool &in_wheel);
+  bool next_event(double bound, bool inclusive, ScheduledEvent &ev);
+  void advance(double bound, bool inclusive);
+  void dispatch(const ScheduledEvent &ev);
+  // dispatch() recorded as a Tracer span
+  void dispatch_traced(const ScheduledEvent &ev);
+  void release(uint32_t slot);
+  // Sends every event through the FEL so that (time, seq) alone orders them
+  void disable_bypass();
+  // Live pending entries in dispatch order; they stay scheduled, cancelled
+  // ones are dropped on the way
+  std::vector<ScheduledEvent> collect_pending();
+  // Destroys every pending event and forgets all slots
+  void discard_pending();
+  // Scheduled time on the tick grid (unchanged in continuous time)
+  double snap(double t) const {
+    return resolution > 0.0 ? to_seconds(to_ticks(t)) : t;
+  }
+  bool is_live(const ScheduledEvent &ev) const {
+    return slots[ev.slot].generation == ev.generation;
+  }
+  size_t live_events() const { return slots.size() - free_slots.size(); }
 
  public:
+  explicit Simulator(QueueKind kind = QueueKind::BinaryHeap);
+  ~Simulator();
+  Simulator(const Simulator &) = delete;
+  Simulator &operator=(const Simulator &) = delete;
+
+  using Tick = int64_t;
+
+  // Sequence numbers of posted arrivals: after every local event at the
+  // same time, then by the poster's key, whenever the arrival is scheduled
+  static constexpr uint64_t REMOTE_SEQ = uint64_t(1) << 63;
+
   double now() const { return current_time; }
 
-  void schedule(Event::PtrEvent event);
+  // Integer time base: every scheduled time is rounded to the nearest
+  // multiple of `seconds` (e.g. 1e-9 for nanosecond ticks), so times are
+  // exact tick counts and events a fraction of a tick apart coincide.
+  // 0 (the default) keeps continuous time. Set before scheduling anything.
+  void set_resolution(double seconds);
+  double get_resolution() const { return resolution; }
+  // Conversions; only meaningful with a resolution set
+  Tick to_ticks(double seconds) const {
+    return std::llround(seconds / resolution);
+  }
+  double to_seconds(Tick ticks) const {
+    return static_cast<double>(ticks) * resolution;
+  }
+  Tick now_ticks() const { return to_ticks(current_time); }
+
+  // Slot width of the timing wheel (micro_step by default), 0 sends every
+  // event to the FEL. Set before scheduling anything.
+  void set_wheel_granularity(double seconds) {
+    wheel.set_granularity(seconds);
+  }
+  QueueKind get_queue_kind() const { return queue_kind; }
+  size_t pending() const {
+    return fel->size() + wheel.size() + immediate.size() - stale;
+  }
+
+  // Compact model event; target must outlive the simulation
+  EventHandle schedule(double t, Model &target, EventType type);
 
+  // Custom event constructed in the pool and recycled after execute()
   template <typename T, typename... Args>
-  void schedule(double t, Args &&...args) {
-    schedule(std::make_shared<T>(t, std::forward<Args>(args)...));
+  EventHandle schedule(double t, Args &&...args) {
+    t = snap(t);
+    check_causality(t);
+    T *event = pool.create<T>(t, std::forward<Args>(args)...);
+    return enqueue(t, nullptr, EventType::Custom, event);
   }
 
+  // O(1): the FEL entry is left in place and skipped when it surfaces
+  bool cancel(EventHandle handle);
+  // O(log n) with the heap backend; returns the handle of the moved event
+  EventHandle reschedule(EventHandle handle, double t);
+  bool is_pending(EventHandle handle) const;
+
+  const EventPoolStats &event_stats() const { return pool.get_stats(); }
+  // Dispatch counters of run()/run_until() (the optimistic parallel engine
+  // keeps its own)
+  const EngineStats &engine_stats() const { return stats; }
+  void reset_engine_stats() { stats = EngineStats(); }
+
+  // State the model keeps per run (the task records), null until installed
+  RunState *run_state() const { return state.get(); }
+  void set_run_state(std::unique_ptr<RunState> s) {
+    s->set_undo(undo_state);
+    state = std::move(s);
+  }
+
+  // Interaction with an entity of (possibly) another partition, arriving at
+  // time t. Crossing partitions requires t >= now() + lookahead. `key`
+  // (< REMOTE_SEQ) must be unique within the run and independent of the
+  // partitioning, e.g. the id of the task being sent: it orders arrivals
+  // that share a time, in sequential and parallel runs alike.
+  void post(size_t target_partition, double t, uint64_t key,
+            RemoteDelivery deliver);
+
   void run(double sim_end_time);
+  // Executes events strictly before bound (one conservative window)
+  void run_until(double bound, double sim_end_time);
+  // Time of the earliest live event, +inf when none
+  double next_time();
   double get_end_time() const { return end_time; }
+  uint64_t events_executed() const { return executed; }
+  SimContext *get_context() const { return context; }
+
+  void attach(ParallelSimulator *engine, size_t index) {
+    parallel = engine;
+    partition = index;
+  }
+  size_t get_partition() const { return partition; }
 };
 
 #endif  // SIMULATOR_H
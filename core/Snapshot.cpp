@@ -0,0 +1,193 @@
+#include "Snapshot.h"
+
+#include <fstream>
+#include <iterator>
+#include <map>
+
+#include "../model/Model.h"
+#include "../utils/IdManager.h"
+#include "../utils/Rng.h"
+#include "ChaosManager.h"
+#include "SimContext.h"
+#include "Simulator.h"
+
+namespace {
+
+const std::string MAGIC = "TANKSNAP";
+constexpr uint32_t VERSION = 4;
+constexpr uint32_t NO_MODEL = UINT32_MAX;
+
+std::map<std::string, Snapshot::EventLoader> &loaders() {
+  static std::map<std::string, Snapshot::EventLoader> registry;
+  return registry;
+}
+
+}  // namespace
+
+SnapshotWriter::SnapshotWriter(std::string &data_,
+                               const std::vector<Model *> &models)
+    : data(data_) {
+  for (uint32_t i = 0; i < models.size(); ++i) index[models[i]] = i;
+}
+
+void SnapshotWriter::model(const Model *m) {
+  if (!m) {
+    pod(NO_MODEL);
+    return;
+  }
+  auto it = index.find(m);
+  if (it == index.end()) {
+    throw std::runtime_error("Snapshot: entity " + std::to_string(m->get_id()) +
+                             " is not in the model table");
+  }
+  pod(it->second);
+}
+
+Model *SnapshotReader::model() {
+  uint32_t i = pod<uint32_t>();
+  if (i == NO_MODEL) return nullptr;
+  if (i >= models.size()) {
+    throw std::runtime_error("Snapshot: entity index out of range");
+  }
+  return models[i];
+}
+
+bool Snapshot::register_event(const std::string &tag, EventLoader loader) {
+  loaders()[tag] = loader;
+  return true;
+}
+
+Snapshot Snapshot::capture(Simulator &sim,
+                           const std::vector<Model *> &models) {
+  if (sim.parallel) {
+    throw std::logic_error("Snapshot: parallel partitions are not supported");
+  }
+  SimContext::Scope scope(sim.context);
+  Snapshot snap;
+  snap.at = sim.current_time;
+  SnapshotWriter out(snap.data, models);
+  snap.data.append(MAGIC);
+  out.pod(VERSION);
+  out.pod(sim.current_time);
+  out.pod(sim.next_seq);
+  out.pod(sim.executed);
+
+  out.pod(Rng::streams());
+  const ChaosManager &chaos = ChaosManager::instance();
+  ChaosManager::Checkpoint c = chaos.checkpoint();
+  out.pod(c.z);
+  out.pod(c.step);
+  out.pod(c.key);
+  out.pod(c.noise);
+  out.pods(chaos.history());
+  out.pod(IdManager::peek());
+
+  out.pod<uint8_t>(sim.state != nullptr);
+  if (sim.state) sim.state->write_snapshot(out);
+  out.pod<uint64_t>(models.size());
+  for (const Model *m : models) m->write_snapshot(out);
+
+  std::vector<ScheduledEvent> pending = sim.collect_pending();
+  out.pod<uint64_t>(pending.size());
+  for (const ScheduledEvent &ev : pending) {
+    out.pod(ev.time);
+    out.pod(ev.seq);
+    out.pod(ev.type);
+    if (ev.type != EventType::Custom) {
+      out.model(ev.target);
+      continue;
+    }
+    const char *tag = ev.event->snapshot_tag();
+    if (!tag) {
+      throw std::runtime_error("Snapshot: pending event type has no loader");
+    }
+    out.string(tag);
+    ev.event->write_snapshot(out);
+  }
+  return snap;
+}
+
+void Snapshot::restore(Simulator &sim,
+                       const std::vector<Model *> &models) const {
+  if (sim.parallel) {
+    throw std::logic_error("Snapshot: parallel partitions are not supported");
+  }
+  SimContext::Scope scope(sim.context);
+  SnapshotReader in(data, models);
+  if (std::string(in.take(MAGIC.size()), MAGIC.size()) != MAGIC ||
+      in.pod<uint32_t>() != VERSION) {
+    throw std::runtime_error("Snapshot: not a snapshot of this version");
+  }
+  sim.discard_pending();
+  sim.current_time = in.pod<double>();
+  uint64_t next_seq = in.pod<uint64_t>();
+  sim.executed = in.pod<uint64_t>();
+
+  Rng::streams() = in.pod<Rng::Streams>();
+  ChaosManager::Checkpoint c;
+  c.z = in.pod<double>();
+  c.step = in.pod<uint64_t>();
+  c.key = in.pod<uint32_t>();
+  c.noise = in.pod<Philox4x32>();
+  std::vector<double> history = in.pods<double>();
+  c.history = history.size();
+  ChaosManager::instance().restore(c, history);
+  IdManager::resume_at(in.pod<int>());
+
+  if (in.pod<uint8_t>()) {
+    if (!sim.state) {
+      throw std::runtime_error("Snapshot: the simulator has no run state");
+    }
+    sim.state->read_snapshot(in);
+  }
+  if (in.pod<uint64_t>() != models.size()) {
+    throw std::runtime_error("Snapshot: model table size differs");
+  }
+  for (Model *m : models) m->read_snapshot(in);
+
+  // Entries come in dispatch order and keep their sequence numbers
+  uint64_t count = in.pod<uint64_t>();
+  for (uint64_t i = 0; i < count; ++i) {
+    double time = in.pod<double>();
+    sim.next_seq = in.pod<uint64_t>();
+    EventType type = in.pod<EventType>();
+    Model *target = nullptr;
+    Event *event = nullptr;
+    if (type == EventType::Custom) {
+      std::string tag = in.string();
+      auto it = loaders().find(tag);
+      if (it == loaders().end()) {
+        throw std::runtime_error("Snapshot: no loader for event '" + tag + "'");
+      }
+      event = it->second(in, sim.pool, time);
+    } else {
+      target = in.model();
+    }
+    sim.enqueue(time, target, type, event);
+  }
+  sim.next_seq = next_seq;
+  if (in.pos != data.size()) {
+    throw std::runtime_error("Snapshot: trailing data");
+  }
+}
+
+void Snapshot::save(const std::string &path) const {
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(&at), sizeof at);
+  out.write(data.data(), static_cast<std::streamsize>(data.size()));
+  if (!out) throw std::runtime_error("Snapshot: cannot write " + path);
+}
+
+Snapshot Snapshot::load(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  Snapshot snap;
+  in.read(reinterpret_cast<char *>(&snap.at), sizeof snap.at);
+  if (in) {
+    snap.data.assign(std::istreambuf_iterator<char>(in),
+                     std::istreambuf_iterator<char>());
+  }
+  if (!in || snap.data.size() < MAGIC.size()) {
+    throw std::runtime_error("Snapshot: cannot read " + path);
+  }
+  return snap;
+}
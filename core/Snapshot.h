@@ -0,0 +1,156 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+class Event;
+class EventPool;
+class Model;
+class Simulator;
+
+/**
+ * @brief Appends state to a snapshot archive
+ *
+ * Values are stored raw (same build, same machine); entities are stored as
+ * their index in the model table handed to Snapshot::capture().
+ */
+class SnapshotWriter {
+ public:
+  template <typename T>
+  void pod(const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>, "raw copy only");
+    data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  void pods(const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable_v<T>, "raw copy only");
+    pod<uint64_t>(values.size());
+    data.append(reinterpret_cast<const char *>(values.data()),
+                values.size() * sizeof(T));
+  }
+
+  void string(const std::string &s) {
+    pod<uint64_t>(s.size());
+    data.append(s);
+  }
+
+  // nullptr or an entity of the model table
+  void model(const Model *m);
+
+ private:
+  friend class Snapshot;
+  SnapshotWriter(std::string &data_, const std::vector<Model *> &models);
+
+  std::string &data;
+  std::unordered_map<const Model *, uint32_t> index;
+};
+
+/**
+ * @brief Reads a snapshot archive back in the order it was written
+ */
+class SnapshotReader {
+ public:
+  template <typename T>
+  T pod() {
+    static_assert(std::is_trivially_copyable_v<T>, "raw copy only");
+    // T need not be default-constructible
+    alignas(T) unsigned char raw[sizeof(T)];
+    std::memcpy(raw, take(sizeof(T)), sizeof(T));
+    return *std::launder(reinterpret_cast<T *>(raw));
+  }
+
+  template <typename T>
+  std::vector<T> pods() {
+    static_assert(std::is_trivially_copyable_v<T>, "raw copy only");
+    uint64_t n = pod<uint64_t>();
+    if (n > (data.size() - pos) / sizeof(T)) truncated();
+    std::vector<T> values;
+    values.reserve(n);
+    for (uint64_t i = 0; i < n; ++i) values.push_back(pod<T>());
+    return values;
+  }
+
+  std::string string() {
+    uint64_t n = pod<uint64_t>();
+    if (n > data.size() - pos) truncated();
+    return std::string(take(n), n);
+  }
+
+  // Entity of the model table given to Snapshot::restore()
+  Model *model();
+
+  template <typename M>
+  std::shared_ptr<M> shared_model() {
+    M *m = dynamic_cast<M *>(model());
+    if (!m) throw std::runtime_error("Snapshot: entity of the wrong type");
+    return std::static_pointer_cast<M>(m->shared_from_this());
+  }
+
+ private:
+  friend class Snapshot;
+  SnapshotReader(const std::string &data_, const std::vector<Model *> &models_)
+      : data(data_), models(models_) {}
+
+  const char *take(size_t n) {
+    if (n > data.size() - pos) truncated();
+    const char *p = data.data() + pos;
+    pos += n;
+    return p;
+  }
+  [[noreturn]] static void truncated() {
+    throw std::runtime_error("Snapshot: truncated data");
+  }
+
+  const std::string &data;
+  const std::vector<Model *> &models;
+  size_t pos = 0;
+};
+
+/**
+ * @brief Complete state of a sequential simulation at one instant
+ *
+ * Holds the pending events, the task store, the state of every entity of a
+ * model table, and the RNG streams, chaos process and id sequence of the
+ * simulation's context. Restoring it into a Simulator whose entities were
+ * built the same way (same order, same ids, same wiring; the policy may
+ * differ) continues the run exactly where the snapshot was taken, so a
+ * warm-up can be simulated once and forked, or a long run restarted from a
+ * checkpoint file. Configuration and metric listeners are not part of it.
+ *
+ * Custom events are saved through Event::snapshot_tag() and
+ * write_snapshot(), and re-created by the loader registered for their tag.
+ */
+class Snapshot {
+ public:
+  using EventLoader = Event *(*)(SnapshotReader &in, EventPool &pool,
+                                 double time);
+
+  // Not a ParallelSimulator partition; run() must not be in progress
+  static Snapshot capture(Simulator &sim, const std::vector<Model *> &models);
+  // Replaces the state of sim and of `models` (same layout as captured)
+  void restore(Simulator &sim, const std::vector<Model *> &models) const;
+
+  double time() const { return at; }
+  size_t bytes() const { return data.size(); }
+
+  void save(const std::string &path) const;
+  static Snapshot load(const std::string &path);
+
+  // Call once per Custom event type, e.g. from a namespace-scope initializer
+  static bool register_event(const std::string &tag, EventLoader loader);
+
+ private:
+  std::string data;
+  double at = 0.0;
+};
+
+#endif  // SNAPSHOT_H
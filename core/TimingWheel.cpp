@@ -0,0 +1,113 @@
+#include "TimingWheel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void TimingWheel::set_granularity(double seconds) {
+  if (!(seconds >= 0.0) || std::isinf(seconds)) {
+    throw std::invalid_argument("TimingWheel: invalid granularity");
+  }
+  if (count != 0) {
+    throw std::logic_error("TimingWheel: granularity changed while in use");
+  }
+  granularity = seconds;
+  per_second = seconds > 0.0 ? 1.0 / seconds : 0.0;
+}
+
+bool TimingWheel::tick_of(double t, uint64_t &tick) const {
+  double x = t * per_second;
+  if (!(x >= 0.0 && x < 9.0e18)) return false;
+  tick = static_cast<uint64_t>(x);  // monotone in t
+  return true;
+}
+
+bool TimingWheel::offer(const ScheduledEvent &ev, double now) {
+  if (!enabled()) return false;
+  uint64_t tick;
+  if (!tick_of(ev.time, tick)) return false;
+  if (count == 0) {
+    uint64_t anchor;
+    if (!tick_of(now, anchor)) return false;
+    cursor = std::min(anchor, tick);
+  }
+  if (tick > cursor && (tick >> 2 * BITS) != (cursor >> 2 * BITS)) {
+    return false;  // past the current rotation
+  }
+  place(ScheduledEvent(ev), tick);
+  ++count;
+  return true;
+}
+
+void TimingWheel::place(ScheduledEvent &&ev, uint64_t tick) {
+  if (tick <= cursor) {
+    due.push_back(std::move(ev));
+    std::push_heap(due.begin(), due.end(), ScheduledEventLater{});
+  } else if ((tick >> BITS) == (cursor >> BITS)) {
+    size_t i = tick & MASK;
+    level0[i].push_back(std::move(ev));
+    mark(used0, i, true);
+  } else {
+    size_t j = (tick >> BITS) & MASK;
+    level1[j].push_back(std::move(ev));
+    mark(used1, j, true);
+  }
+}
+
+const ScheduledEvent &TimingWheel::top() {
+  if (due.empty()) advance();
+  return due.front();
+}
+
+ScheduledEvent TimingWheel::pop() {
+  top();
+  std::pop_heap(due.begin(), due.end(), ScheduledEventLater{});
+  ScheduledEvent ev = std::move(due.back());
+  due.pop_back();
+  --count;
+  return ev;
+}
+
+void TimingWheel::advance() {
+  // Every slotted entry is past the cursor and within its rotation, so a
+  // non-empty wheel always finds one of these two
+  for (;;) {
+    size_t i = next_used(used0, (cursor & MASK) + 1);
+    if (i != NONE) {
+      cursor = (cursor & ~MASK) | i;
+      mark(used0, i, false);
+      due.swap(level0[i]);
+      std::make_heap(due.begin(), due.end(), ScheduledEventLater{});
+      return;
+    }
+    size_t j = next_used(used1, ((cursor >> BITS) & MASK) + 1);
+    if (j == NONE) return;
+    cursor = (cursor >> 2 * BITS << 2 * BITS) | (uint64_t(j) << BITS);
+    mark(used1, j, false);
+    std::vector<ScheduledEvent> &turn = level1[j];
+    for (ScheduledEvent &ev : turn) {
+      uint64_t tick = 0;
+      tick_of(ev.time, tick);
+      place(std::move(ev), tick);
+    }
+    turn.clear();
+    if (!due.empty()) return;
+  }
+}
+
+size_t TimingWheel::next_used(const Bitmap &used, size_t from) {
+  for (size_t w = from / 64; w < used.size(); ++w) {
+    uint64_t bits = used[w];
+    if (w == from / 64) bits &= ~uint64_t(0) << (from % 64);
+    if (bits) return w * 64 + __builtin_ctzll(bits);
+  }
+  return NONE;
+}
+
+void TimingWheel::mark(Bitmap &used, size_t i, bool on) {
+  if (on) {
+    used[i / 64] |= uint64_t(1) << (i % 64);
+  } else {
+    used[i / 64] &= ~(uint64_t(1) << (i % 64));
+  }
+}
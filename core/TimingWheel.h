@@ -0,0 +1,62 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EventQueue.h"
+
+/**
+ * @brief Hierarchical timing wheel for near-future events
+ *
+ * Time is cut into slots of `granularity` seconds. Level 0 has one slot per
+ * tick of the current 256-tick turn, level 1 one slot per turn of the
+ * current 65536-tick rotation; an entry that falls later than the rotation
+ * is refused and stays in the main FEL. Entries of the current tick (or
+ * earlier, after an optimistic rollback) wait in `due`, a binary heap in
+ * ScheduledEventLater order, so the wheel serves exactly the (time, seq)
+ * order of the FEL backends while push is O(1) and only one slot is ever
+ * sorted. Reaching a level-1 slot spreads its entries over level 0.
+ */
+class TimingWheel {
+ public:
+  static constexpr unsigned BITS = 8;
+  static constexpr size_t SLOTS = size_t(1) << BITS;
+
+  // 0 disables the wheel; only while empty
+  void set_granularity(double seconds);
+  double get_granularity() const { return granularity; }
+  bool enabled() const { return granularity > 0.0; }
+
+  // Takes ev when it lies within the current rotation; `now` anchors an
+  // empty wheel
+  bool offer(const ScheduledEvent &ev, double now);
+  // Earliest entry; the wheel must not be empty
+  const ScheduledEvent &top();
+  ScheduledEvent pop();
+  bool empty() const { return count == 0; }
+  size_t size() const { return count; }
+
+ private:
+  static constexpr uint64_t MASK = SLOTS - 1;
+  static constexpr size_t NONE = SLOTS;
+  using Bitmap = std::array<uint64_t, SLOTS / 64>;
+
+  double granularity = 0.0;
+  double per_second = 0.0;  // 1 / granularity
+  uint64_t cursor = 0;      // tick of `due`
+  size_t count = 0;
+  std::vector<ScheduledEvent> due;  // ticks <= cursor
+  std::array<std::vector<ScheduledEvent>, SLOTS> level0, level1;
+  Bitmap used0{}, used1{};  // non-empty slots
+
+  bool tick_of(double t, uint64_t &tick) const;
+  void place(ScheduledEvent &&ev, uint64_t tick);
+  void advance();
+  static size_t next_used(const Bitmap &used, size_t from);
+  static void mark(Bitmap &used, size_t i, bool on);
+};
+
+#endif  // TIMINGWHEEL_H
@@ -0,0 +1,101 @@
+#include "Tracer.h"
+
+#include <chrono>
+#include <fstream>
+
+std::atomic<bool> Tracer::on{false};
+size_t Tracer::capacity = size_t(1) << 22;
+std::mutex Tracer::registry_mtx;
+std::vector<std::unique_ptr<Tracer::Buffer>> Tracer::registry;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+const Clock::time_point epoch = Clock::now();
+
+// Names are string literals or event tags; keep the JSON valid regardless
+void write_string(std::ofstream &out, const char *s) {
+  out << '"';
+  for (; *s; ++s) {
+    if (*s == '"' || *s == '\\') out << '\\';
+    out << *s;
+  }
+  out << '"';
+}
+
+}  // namespace
+
+int64_t Tracer::now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                              epoch)
+      .count();
+}
+
+Tracer::Buffer &Tracer::local() {
+  thread_local Buffer *buffer = nullptr;
+  if (!buffer) {
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    registry.push_back(std::make_unique<Buffer>());
+    buffer = registry.back().get();
+    buffer->thread = static_cast<int>(registry.size());
+  }
+  return *buffer;
+}
+
+void Tracer::record(const Span &span) {
+  Buffer &buffer = local();
+  if (buffer.spans.size() < capacity) {
+    buffer.spans.push_back(span);
+  } else {
+    ++buffer.dropped;
+  }
+}
+
+bool Tracer::write(const std::string &path) {
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  std::ofstream out(path);
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&] {
+    out << (first ? "\n" : ",\n");
+    first = false;
+  };
+  out.setf(std::ios::fixed);
+  out.precision(3);  // microseconds with ns digits
+  for (const auto &buffer : registry) {
+    separator();
+    out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+        << buffer->thread << ",\"args\":{\"name\":\"thread "
+        << buffer->thread << "\",\"dropped_spans\":" << buffer->dropped
+        << "}}";
+    for (const Span &s : buffer->spans) {
+      separator();
+      out << "{\"name\":";
+      write_string(out, s.name);
+      out << ",\"cat\":\"" << s.category << "\",\"ph\":\"X\",\"ts\":"
+          << s.start_ns / 1e3 << ",\"dur\":" << s.duration_ns / 1e3
+          << ",\"pid\":1,\"tid\":" << buffer->thread << ",\"args\":{";
+      const char *comma = "";
+      if (s.type) {
+        out << "\"type\":\"" << s.type << '"';
+        comma = ",";
+      }
+      if (s.entity >= 0) {
+        out << comma << "\"entity\":" << s.entity;
+        comma = ",";
+      }
+      if (s.partition >= 0) out << comma << "\"partition\":" << s.partition;
+      out << "}}";
+    }
+  }
+  out << "\n]}\n";
+  return static_cast<bool>(out);
+}
+
+void Tracer::clear() {
+  std::lock_guard<std::mutex> lock(registry_mtx);
+  for (auto &buffer : registry) {
+    buffer->spans.clear();
+    buffer->dropped = 0;
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Wall-clock spans of engine execution, written as Chrome Trace
+ * Event JSON (chrome://tracing, ui.perfetto.dev)
+ *
+ * Each thread appends to its own buffer, registered once under a lock, so
+ * recording never synchronizes. While disabled an instrumented site costs
+ * one branch; defining TANK_NO_TRACE compiles the sites out entirely.
+ * write() and clear() must not race with threads still recording.
+ */
+class Tracer {
+ public:
+  struct Span {
+    const char *name;
+    const char *category;  // "engine" phase or "event" dispatch
+    const char *type;      // EventType name, nullptr for phases
+    int entity;            // -1: none
+    int partition;         // -1: sequential run
+    int64_t start_ns;
+    int64_t duration_ns;
+  };
+
+  static bool enabled() {
+#ifdef TANK_NO_TRACE
+    return false;
+#else
+    return on.load(std::memory_order_relaxed);
+#endif
+  }
+  static void enable(bool flag = true) { on.store(flag); }
+
+  // Spans kept per thread; later ones are counted as dropped
+  static void set_capacity(size_t spans) { capacity = spans; }
+
+  // Nanoseconds since the process started tracing
+  static int64_t now_ns();
+  static void record(const Span &span);
+
+  // Chrome Trace Event JSON; false when the file cannot be written
+  static bool write(const std::string &path);
+  // Forgets the recorded spans (the buffers stay registered)
+  static void clear();
+
+ private:
+  struct Buffer {
+    int thread;
+    size_t dropped = 0;
+    std::vector<Span> spans;
+  };
+
+  static std::atomic<bool> on;
+  static size_t capacity;
+  static std::mutex registry_mtx;
+  static std::vector<std::unique_ptr<Buffer>> registry;
+
+  static Buffer &local();
+};
+
+/**
+ * @brief Records an "engine" span from construction to destruction
+ */
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char *name, int partition = -1)
+      : active(Tracer::enabled()) {
+    if (active) {
+      span = {name, "engine", nullptr, -1, partition, Tracer::now_ns(), 0};
+    }
+  }
+  ~TraceSpan() {
+    if (active) {
+      span.duration_ns = Tracer::now_ns() - span.start_ns;
+      Tracer::record(span);
+    }
+  }
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+ private:
+  bool active;
+  Tracer::Span span;
+};
+
+#endif  // TRACER_H
@@ -0,0 +1,41 @@
+#ifndef OFFLOADARRIVALEVENT_H
+#define OFFLOADARRIVALEVENT_H
+
+#include "../core/Event.h"
+#include "../core/Simulator.h"
+#include "../core/Snapshot.h"
+#include "../model/MetricNames.h"
+#include "../model/Model.h"
+#include "../model/TaskStore.h"
+
+// Offloaded task reaching its RSU after Config UPLINK_LATENCY; carries the
+// record, stored in the receiving simulation on arrival
+class OffloadArrivalEvent : public Event {
+  Model::PtrModel device = nullptr;
+  Task task;
+
+ public:
+  OffloadArrivalEvent(double t, Model::PtrModel device_, const Task &task_)
+      : Event(t), device(device_), task(task_) {}
+  Model *subject() const override { return device.get(); }
+  const char *snapshot_tag() const override { return "OffloadArrival"; }
+  void write_snapshot(SnapshotWriter &out) const override {
+    out.model(device.get());
+    out.pod(task);
+  }
+  static Event *load(SnapshotReader &in, EventPool &pool, double t) {
+    Model::PtrModel device = in.shared_model<Model>();
+    return pool.create<OffloadArrivalEvent>(t, device, in.pod<Task>());
+  }
+  void execute(Simulator &sim) override {
+    if (!device->accept_processing_task(sim, TaskStore::of(sim).add(task))) {
+      device->report_metric(sim, metrics::FullQueueError, 1.0,
+                            metric_tags::Remote, task.get_id());
+    }
+  }
+};
+
+inline const bool offload_arrival_snapshot =
+    Snapshot::register_event("OffloadArrival", &OffloadArrivalEvent::load);
+
+#endif  // OFFLOADARRIVALEVENT_H
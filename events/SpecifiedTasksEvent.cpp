@@ -1,39 +1,50 @@
 #include "SpecifiedTasksEvent.h"
 
-#include <sstream>
-
+#include "../core/Simulator.h"
+#include "../core/Snapshot.h"
 #include "../logger.h"
+#include "../model/MetricNames.h"
 #include "../model/Task.h"
+#include "../model/TaskStore.h"
 #include "../utils/Rng.h"
 
-size_t SpecifiedTasksEvent::index = 0;
-std::vector<Task::PtrTask> SpecifiedTasksEvent::tasks = {};
-
 void SpecifiedTasksEvent::execute(Simulator &sim) {
-  if (index < tasks.size()) {
-    if (!tasks[index]) {
-      return;
-    }
-    Task::PtrTask task = tasks[index++];
-    task->set_origin_node_id(model->get_id());  // Set origin
-    model->report_metric(sim, "TaskTotalCycles", task->total_cycles(), "",
-                         task->get_id());
-    std::stringstream ss;
-    ss << "Task " << task->get_id() << " | Node " << model->get_id()
-       << " | TASK_GENERATED"
-       << " | data_size=" << task->get_data_size()
-       << " | cycles per byte=" << task->get_cycles()
-       << " | deadline=" << task->get_deadline();
-    LOG_INFO(sim.now(), ss.str());
+  if (index < tasks->size()) {
+    Task task = (*tasks)[index];
+    task.set_origin_node_id(model->get_id());  // Set origin
+    model->report_metric(sim, metrics::TaskTotalCycles, task.total_cycles(),
+                         MetricRegistry::EMPTY, task.get_id());
+    LOG_INFO(sim.now(),
+             "Task {} | Node {} | TASK_GENERATED | data_size={} | "
+             "cycles per byte={} | deadline={}",
+             task.get_id(), model->get_id(), task.get_data_size(),
+             task.get_cycles(), task.get_deadline());
 
     // Push to decision queue
-    model->add_task_to_decision(sim, task);
-    if (index < tasks.size()) {
-      sim.schedule<SpecifiedTasksEvent>(tasks[index]->get_timestamp(), model);
-    } else {
-      sim.schedule<SpecifiedTasksEvent>(sim.get_end_time() + 1, model);
+    model->add_task_to_decision(sim, TaskStore::of(sim).add(task));
+    size_t next = index + 1;
+    if (next < tasks->size()) {
+      sim.schedule<SpecifiedTasksEvent>((*tasks)[next].get_timestamp(), model,
+                                        tasks, next);
     }
-  } else {
-    sim.schedule<SpecifiedTasksEvent>(sim.get_end_time() + 1, model);
   }
 }
+
+// The list is saved with the event: a vehicle has at most one pending
+void SpecifiedTasksEvent::write_snapshot(SnapshotWriter &out) const {
+  out.model(model.get());
+  out.pods(*tasks);
+  out.pod(index);
+}
+
+Event *SpecifiedTasksEvent::load(SnapshotReader &in, EventPool &pool,
+                                 double t) {
+  Vehicle::PtrVehicle model = in.shared_model<Vehicle>();
+  auto tasks = std::make_shared<const std::vector<Task>>(in.pods<Task>());
+  return pool.create<SpecifiedTasksEvent>(t, model, tasks, in.pod<size_t>());
+}
+
+namespace {
+const bool registered =
+    Snapshot::register_event("SpecifiedTasks", &SpecifiedTasksEvent::load);
+}  // namespace
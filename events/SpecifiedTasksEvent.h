@@ -1,20 +1,33 @@
 #ifndef SPECIFIEDTASKSEVENT_H
 #define SPECIFIEDTASKSEVENT_H
 
+#include <memory>
+#include <vector>
+
 #include "../core/Event.h"
 #include "../model/Vehicle.h"
 
+// Releases a predefined task list one task at a time, each at its timestamp;
+// the records are copied into the simulation's TaskStore, so a list can be
+// replayed by several runs
 class SpecifiedTasksEvent : public Event {
+ public:
+  using TaskList = std::shared_ptr<const std::vector<Task>>;
+
+ private:
   Vehicle::PtrVehicle model = nullptr;
-  static size_t index;
+  TaskList tasks;
+  size_t index = 0;  // task released by this event
 
  public:
-  static std::vector<Task::PtrTask> tasks;
-  static void reset() { index = 0; }
-
-  SpecifiedTasksEvent(double t, Vehicle::PtrVehicle model_)
-      : Event(t), model(model_) {}
+  SpecifiedTasksEvent(double t, Vehicle::PtrVehicle model_, TaskList tasks_,
+                      size_t index_ = 0)
+      : Event(t), model(model_), tasks(std::move(tasks_)), index(index_) {}
   void execute(Simulator &sim) override;
+  Model *subject() const override { return model.get(); }
+  const char *snapshot_tag() const override { return "SpecifiedTasks"; }
+  void write_snapshot(SnapshotWriter &out) const override;
+  static Event *load(SnapshotReader &in, EventPool &pool, double t);
 };
 
 #endif  // SPECIFIEDTASKSEVENT_H
@@ -1,34 +1,52 @@
 #include "TaskGenerationEvent.h"
 
-#include <sstream>
-
 #include "../core/ChaosManager.h"
+#include "../core/Simulator.h"
+#include "../core/Snapshot.h"
 #include "../logger.h"
+#include "../model/MetricNames.h"
 #include "../model/Task.h"
+#include "../model/TaskStore.h"
 #include "../utils/Rng.h"
+#include "../utils/Workload.h"
 
 void TaskGenerationEvent::execute(Simulator &sim) {
-  Task::PtrTask task = std::make_shared<Task>(sim);
-  task->set_origin_node_id(model->get_id());  // Set origin
-  model->report_metric(sim, "TaskTotalCycles", task->total_cycles());
-  std::stringstream ss;
-  ss << "Task " << task->get_id() << " | Node " << model->get_id()
-     << " | TASK_GENERATED"
-     << " | lambda=" << lambda << " | deadline=" << task->get_deadline();
-  LOG_INFO(sim.now(), ss.str());
+  Model::DrawScope scope(*model);
+  Workload::Draws draws = Workload::instance().next();
+  Task task(sim, draws, model->next_task_id());
+  task.set_origin_node_id(model->get_id());  // Set origin
+  model->report_metric(sim, metrics::TaskTotalCycles, task.total_cycles());
+  LOG_INFO(sim.now(),
+           "Task {} | Node {} | TASK_GENERATED | lambda={} | deadline={}",
+           task.get_id(), model->get_id(), lambda, task.get_deadline());
   // Push to decision queue
-  model->add_task_to_decision(sim, task);
+  model->add_task_to_decision(sim, TaskStore::of(sim).add(task));
 
   // Calculate inter-arrival time
-  double inter_arrival = Rng::exponential(lambda);
+  double inter_arrival = draws.gap / lambda;
 
   // Non-stationary arrivals in chaos mode
-  if (Config::FIELD_TOTAL_CHAOS) {
+  if (Config::get().FIELD_TOTAL_CHAOS) {
     double drift = ChaosManager::instance().get_state();
     inter_arrival = Rng::pdrift(inter_arrival, drift);
   }
 
   double next_event = sim.now() + inter_arrival;
-  sim.schedule(
-      std::make_shared<TaskGenerationEvent>(next_event, model, lambda));
+  sim.schedule<TaskGenerationEvent>(next_event, model, lambda);
+}
+
+void TaskGenerationEvent::write_snapshot(SnapshotWriter &out) const {
+  out.model(model.get());
+  out.pod(lambda);
 }
+
+Event *TaskGenerationEvent::load(SnapshotReader &in, EventPool &pool,
+                                 double t) {
+  Vehicle::PtrVehicle model = in.shared_model<Vehicle>();
+  return pool.create<TaskGenerationEvent>(t, model, in.pod<double>());
+}
+
+namespace {
+const bool registered =
+    Snapshot::register_event("TaskGeneration", &TaskGenerationEvent::load);
+}  // namespace
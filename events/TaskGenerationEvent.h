@@ -7,14 +7,18 @@
 
 class TaskGenerationEvent : public Event {
   Vehicle::PtrVehicle model = nullptr;
-  double lambda = Config::TRAFFIC_LAMBDA;
+  double lambda = Config::get().TRAFFIC_LAMBDA;
 
  public:
   TaskGenerationEvent(double t, Vehicle::PtrVehicle model_,
-                      double lambda_ = Config::TRAFFIC_LAMBDA)
+                      double lambda_ = Config::get().TRAFFIC_LAMBDA)
       : Event(t), model(model_), lambda(lambda_) {}
   void execute(Simulator &sim) override;
+  Model *subject() const override { return model.get(); }
   void schedule_next(Simulator &sim);
+  const char *snapshot_tag() const override { return "TaskGeneration"; }
+  void write_snapshot(SnapshotWriter &out) const override;
+  static Event *load(SnapshotReader &in, EventPool &pool, double t);
 };
 
 #endif  // TASKGENERATIONEVENT_H
@@ -1,13 +1,24 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #if defined(_MSC_VER)
 #define __METHOD_NAME__ __FUNCSIG__
@@ -20,73 +31,413 @@
 // Níveis de Log
 enum class LogLevel { DEBUG, INFO, WARN, ERROR, DATA };
 
+// Nível mínimo compilado: -DTANK_LOG_LEVEL=WARN remove do binário as
+// chamadas LOG_DEBUG/LOG_INFO (argumentos inclusive); OFF remove todas
+#define TANK_LOG_LEVEL_DEBUG 0
+#define TANK_LOG_LEVEL_INFO 1
+#define TANK_LOG_LEVEL_WARN 2
+#define TANK_LOG_LEVEL_ERROR 3
+#define TANK_LOG_LEVEL_OFF 5
+#ifndef TANK_LOG_LEVEL
+#define TANK_LOG_LEVEL DEBUG
+#endif
+#define TANK_LOG_PASTE(a, b) a##b
+#define TANK_LOG_VALUE(level) TANK_LOG_PASTE(TANK_LOG_LEVEL_, level)
+
+inline constexpr LogLevel COMPILED_LOG_LEVEL =
+    static_cast<LogLevel>(TANK_LOG_VALUE(TANK_LOG_LEVEL));
+
+/**
+ * @brief Uma linha de trace ainda não formatada
+ *
+ * Formato literal com "{}" no lugar de cada argumento; textos são literais
+ * (TEXT) ou cópias que a thread de escrita libera (OWNED_TEXT).
+ */
+struct LogRecord {
+  static constexpr size_t MAX_ARGS = 6;
+  enum Kind : uint8_t { INT, DOUBLE, TEXT, OWNED_TEXT };
+  union Value {
+    int64_t i;
+    double d;
+    const char *s;
+  };
+
+  double time;
+  const char *format;
+  LogLevel level;
+  uint8_t argc;
+  Kind kinds[MAX_ARGS];
+  Value args[MAX_ARGS];
+
+  void add(int64_t v) { set(INT).i = v; }
+  void add(double v) { set(DOUBLE).d = v; }
+  void add(const char *v) { set(TEXT).s = v; }
+  void add(const std::string &v) {
+    char *copy = new char[v.size() + 1];
+    std::memcpy(copy, v.c_str(), v.size() + 1);
+    set(OWNED_TEXT).s = copy;
+  }
+  template <typename T>
+  std::enable_if_t<std::is_integral_v<T>> add(T v) {
+    add(static_cast<int64_t>(v));
+  }
+  void add(float v) { add(static_cast<double>(v)); }
+
+  // "[TIME] [LEVEL] mensagem\n", como o trace síncrono escrevia
+  void format_to(std::string &out) const {
+    char buf[64];
+    out += '[';
+    out.append(buf, std::to_chars(buf, buf + sizeof buf, time,
+                                  std::chars_format::fixed, 4)
+                        .ptr);
+    out += "] ";
+    switch (level) {
+      case LogLevel::DEBUG:
+        out += "[DEBUG] ";
+        break;
+      case LogLevel::INFO:
+        out += "[INFO]  ";
+        break;
+      case LogLevel::WARN:
+        out += "[WARN]  ";
+        break;
+      case LogLevel::ERROR:
+        out += "[ERROR] ";
+        break;
+      default:
+        break;
+    }
+    message_to(out);
+    out += '\n';
+  }
+
+  void message_to(std::string &out) const {
+    char buf[64];
+    const char *p = format;
+    for (uint8_t next = 0; next < argc; ++next) {
+      const char *hole = std::strstr(p, "{}");
+      if (!hole) break;
+      out.append(p, hole);
+      p = hole + 2;
+      const Value &v = args[next];
+      switch (kinds[next]) {
+        case INT:
+          out.append(buf, std::to_chars(buf, buf + sizeof buf, v.i).ptr);
+          break;
+        case DOUBLE:  // %g, como o iostream padrão
+          out.append(buf, std::to_chars(buf, buf + sizeof buf, v.d,
+                                        std::chars_format::general, 6)
+                              .ptr);
+          break;
+        default:
+          out += v.s;
+          break;
+      }
+    }
+    out += p;
+  }
+
+  void release() {
+    for (uint8_t k = 0; k < argc; ++k) {
+      if (kinds[k] == OWNED_TEXT) delete[] args[k].s;
+    }
+  }
+
+ private:
+  Value &set(Kind kind) {
+    kinds[argc] = kind;
+    return args[argc++];
+  }
+};
+
+// Fila circular de um produtor (thread da simulação) e um consumidor (thread
+// de escrita), sem locks
+class LogRing {
+  static constexpr size_t CAPACITY = 1 << 12;
+  std::unique_ptr<LogRecord[]> slots{new LogRecord[CAPACITY]};
+  alignas(64) std::atomic<size_t> head{0};  // próximo a escrever
+  alignas(64) std::atomic<size_t> tail{0};  // próximo a ler
+
+ public:
+  bool push(const LogRecord &record) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == CAPACITY) return false;
+    slots[h & (CAPACITY - 1)] = record;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename F>
+  size_t drain(F &&consume) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    size_t h = head.load(std::memory_order_acquire);
+    for (size_t i = t; i != h; ++i) consume(slots[i & (CAPACITY - 1)]);
+    tail.store(h, std::memory_order_release);
+    return h - t;
+  }
+};
+
 class Logger {
  private:
-  std::ofstream traceFile;
   std::ofstream metricsFile;
-  std::mutex
-      mtx;  // Garante thread-safety (caso expanda para multithread no futuro)
+  std::mutex mtx;  // métricas e abertura do trace
   bool debugEnabled = true;
+  bool traceEnabled = true;
 
-  // Construtor privado (Singleton)
-  Logger() {
+  // Trace assíncrono: cada thread produtora grava registros binários no seu
+  // LogRing; uma thread de escrita formata e grava em lotes
+  const uint64_t uid = next_uid()++;
+  std::string tracePath;
+  std::ofstream traceFile;
+  std::atomic<bool> started{false};
+  std::thread writer;
+  std::atomic<bool> stopping{false};
+  std::mutex ringsMtx;
+  std::map<std::thread::id, std::unique_ptr<LogRing>> rings;
+  std::mutex wakeMtx;
+  std::condition_variable wake;  // thread de escrita
+  std::condition_variable done;  // flush()
+  std::condition_variable space;  // produtores com a fila cheia
+  std::atomic<int> waiting{0};
+  uint64_t flushRequested = 0;
+  uint64_t flushed = 0;
+
+  static constexpr size_t BATCH_BYTES = 1 << 16;
+
+  // Construtor privado (Singleton): trace em logs/simulation_trace.log, a
+  // menos que open() escolha o arquivo da execução antes da primeira linha
+  Logger() : tracePath("logs/simulation_trace.log") {
     // Cria diretório de logs se não existir (C++17)
     std::filesystem::create_directory("logs");
-    traceFile.open("logs/simulation_trace.log",
-                   std::ios::out | std::ios::trunc);
     // Header do arquivo de métricas (CSV)
-    std::filesystem::create_directory("logs");
     metricsFile.open("results/simulation_metrics.csv",
                      std::ios::out | std::ios::trunc);
     metricsFile << "Time,EntityID,MetricType,Value,Extra\n";
   }
 
+  static Logger *&bound() {
+    static thread_local Logger *logger = nullptr;
+    return logger;
+  }
+
+  static std::vector<LogRecord> *&bound_buffer() {
+    static thread_local std::vector<LogRecord> *buffer = nullptr;
+    return buffer;
+  }
+
+  static std::atomic<uint64_t> &next_uid() {
+    static std::atomic<uint64_t> uid{1};
+    return uid;
+  }
+
+  // Fila da thread atual neste Logger
+  LogRing &ring() {
+    thread_local uint64_t owner = 0;
+    thread_local LogRing *cached = nullptr;
+    if (owner == uid) return *cached;
+    std::lock_guard<std::mutex> lock(ringsMtx);
+    auto &slot = rings[std::this_thread::get_id()];
+    if (!slot) slot = std::make_unique<LogRing>();
+    owner = uid;
+    cached = slot.get();
+    return *cached;
+  }
+
+  void start() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (started.load(std::memory_order_relaxed)) return;
+    auto parent = std::filesystem::path(tracePath).parent_path();
+    if (!parent.empty()) std::filesystem::create_directories(parent);
+    traceFile.open(tracePath, std::ios::out | std::ios::trunc);
+    stopping = false;
+    writer = std::thread([this] { write_loop(); });
+    started.store(true, std::memory_order_release);
+  }
+
+  void stop() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!started.load(std::memory_order_relaxed)) return;
+    {
+      std::lock_guard<std::mutex> wlock(wakeMtx);
+      stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    traceFile.close();
+    started.store(false, std::memory_order_release);
+  }
+
+  void write_loop() {
+    std::string batch;
+    batch.reserve(2 * BATCH_BYTES);
+    std::vector<LogRing *> snapshot;
+    for (;;) {
+      bool stop;
+      uint64_t request;
+      {
+        std::lock_guard<std::mutex> lock(wakeMtx);
+        stop = stopping;
+        request = flushRequested;
+      }
+      {
+        std::lock_guard<std::mutex> lock(ringsMtx);
+        snapshot.clear();
+        for (auto &entry : rings) snapshot.push_back(entry.second.get());
+      }
+      size_t drained = 0;
+      for (LogRing *r : snapshot) {
+        drained += r->drain([&](LogRecord &record) {
+          record.format_to(batch);
+          record.release();
+          if (batch.size() >= BATCH_BYTES) {
+            traceFile.write(batch.data(), batch.size());
+            batch.clear();
+          }
+        });
+      }
+      if (drained > 0) {
+        if (waiting.load() > 0) space.notify_all();
+        continue;
+      }
+      // Nada pendente: grava o lote parcial e atende flush()
+      traceFile.write(batch.data(), batch.size());
+      batch.clear();
+      if (request != flushed) {
+        traceFile.flush();
+        std::lock_guard<std::mutex> lock(wakeMtx);
+        flushed = request;
+        done.notify_all();
+      }
+      if (stop) break;
+      std::unique_lock<std::mutex> lock(wakeMtx);
+      wake.wait_for(lock, std::chrono::milliseconds(2), [&] {
+        return stopping || flushRequested != flushed;
+      });
+    }
+  }
+
+  void push(const LogRecord &record) {
+    if (!started.load(std::memory_order_acquire)) start();
+    LogRing &r = ring();
+    if (!r.push(record)) {  // cheia: acorda a thread de escrita e espera
+      std::unique_lock<std::mutex> lock(wakeMtx);
+      ++waiting;
+      wake.notify_one();
+      // O timeout cobre um aviso perdido entre o teste e a espera
+      while (!r.push(record)) {
+        space.wait_for(lock, std::chrono::milliseconds(1));
+      }
+      --waiting;
+    }
+    // Opcional: Espelhar erros críticos no console
+    if (record.level == LogLevel::ERROR) {
+      std::string msg;
+      record.message_to(msg);
+      std::cerr << "\033[1;31m[ERROR] " << msg << "\033[0m" << std::endl;
+    }
+  }
+
+ public:
+  // Logger de uma SimContext: trace em trace_path (vazio desabilita o trace)
+  explicit Logger(const std::string &trace_path) : tracePath(trace_path) {
+    traceEnabled = !trace_path.empty();
+  }
+
   ~Logger() {
-    if (traceFile.is_open()) traceFile.close();
+    stop();
+    for (auto &entry : rings) {  // registros de depois do stop()
+      entry.second->drain([](LogRecord &record) { record.release(); });
+    }
     if (metricsFile.is_open()) metricsFile.close();
   }
 
- public:
-  // Acesso à instância única
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+
+  // Acesso à instância única (ou à da SimContext ligada à thread)
   static Logger &instance() {
     static Logger instance;
-    return instance;
+    Logger *b = bound();
+    return b ? *b : instance;
   }
 
-  // Desabilitar DEBUG para rodar simulações pesadas mais rápido
-  void setDebug(bool enable) { debugEnabled = enable; }
+  // Liga instance() da thread atual a outro Logger (nullptr: o global);
+  // retorna a ligação anterior
+  static Logger *bind(Logger *logger) {
+    Logger *previous = bound();
+    bound() = logger;
+    return previous;
+  }
 
-  // 1. LOG DE RASTREIO (Humano)
-  void log(double simTime, LogLevel level, const std::string &msg) {
-    if (level == LogLevel::DEBUG && !debugEnabled) return;
+  // Partições de uma execução paralela otimista guardam os registros da
+  // thread atual até o GVT confirmá-los (write()); retorna a ligação anterior
+  static std::vector<LogRecord> *bind_buffer(std::vector<LogRecord> *buffer) {
+    std::vector<LogRecord> *previous = bound_buffer();
+    bound_buffer() = buffer;
+    return previous;
+  }
+
+  // Grava um registro guardado (ParallelSimulator, no commit)
+  void write(const LogRecord &record) { push(record); }
 
+  // Trace desta execução em path (ex.: logs/<execução>.log), para que
+  // processos em paralelo não escrevam no mesmo arquivo; grava antes o que
+  // estiver pendente no arquivo anterior
+  void open(const std::string &path) {
+    stop();
     std::lock_guard<std::mutex> lock(mtx);
+    tracePath = path;
+  }
 
-    // Formato: [TIME] [LEVEL] Message
-    traceFile << std::fixed << std::setprecision(4) << "[" << simTime << "] ";
+  // Espera a thread de escrita gravar tudo o que foi registrado até aqui
+  void flush() {
+    if (!started.load(std::memory_order_acquire)) return;
+    std::unique_lock<std::mutex> lock(wakeMtx);
+    uint64_t request = ++flushRequested;
+    wake.notify_one();
+    done.wait(lock, [&] { return flushed >= request; });
+  }
 
-    switch (level) {
-      case LogLevel::DEBUG:
-        traceFile << "[DEBUG] ";
-        break;
-      case LogLevel::INFO:
-        traceFile << "[INFO]  ";
-        break;
-      case LogLevel::WARN:
-        traceFile << "[WARN]  ";
-        break;
-      case LogLevel::ERROR:
-        traceFile << "[ERROR] ";
-        break;
-      default:
-        break;
-    }
-    traceFile << msg << std::endl;
+  // Desabilitar DEBUG para rodar simulações pesadas mais rápido
+  void setDebug(bool enable) { debugEnabled = enable; }
 
-    // Opcional: Espelhar erros críticos no console
-    if (level == LogLevel::ERROR) {
-      std::cerr << "\033[1;31m[ERROR] " << msg << "\033[0m" << std::endl;
+  // Desabilitar todo o trace (benchmarks, execuções paralelas)
+  void setTrace(bool enable) { traceEnabled = enable; }
+  bool tracing() const { return traceEnabled; }
+
+  // Se uma linha deste nível seria gravada (os macros LOG_* testam antes de
+  // avaliar os argumentos)
+  bool enabled(LogLevel level) const {
+    if (level < COMPILED_LOG_LEVEL || !traceEnabled) return false;
+    return level != LogLevel::DEBUG || debugEnabled;
+  }
+
+  // 1. LOG DE RASTREIO (Humano)
+  // Formato literal com "{}" por argumento: só o registro binário é montado
+  // aqui; a formatação fica para a thread de escrita. Textos const char*
+  // devem ser literais; std::string é copiada.
+  template <size_t N, typename... Args>
+  void log(double simTime, LogLevel level, const char (&format)[N],
+           const Args &...args) {
+    static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS,
+                  "too many log arguments");
+    if (!enabled(level)) return;
+    LogRecord record;
+    record.time = simTime;
+    record.format = format;
+    record.level = level;
+    record.argc = 0;
+    (record.add(args), ...);
+    if (std::vector<LogRecord> *buffer = bound_buffer()) {
+      buffer->push_back(record);
+      return;
     }
+    push(record);
+  }
+
+  // Mensagem já formatada (copiada)
+  void log(double simTime, LogLevel level, const std::string &msg) {
+    log(simTime, level, "{}", msg);
   }
 
   // 2. LOG DE MÉTRICAS (Máquina/Gráficos)
@@ -103,11 +454,23 @@ class Logger {
 // ********** Macros para Facilidade de Uso **********
 // Isso captura a instância do Simulador para pegar o tempo automaticamente se
 // disponível, ou você pode passar o tempo explicitamente. Para este exemplo,
-// assumimos passagem explícita do tempo 't'.
+// assumimos passagem explícita do tempo 't'. Argumentos extras preenchem os
+// "{}" de um formato literal. Tempo e argumentos só são avaliados se o nível
+// estiver habilitado; abaixo de TANK_LOG_LEVEL a chamada não gera código.
+
+#define TANK_LOG(level, t, msg, ...)                       \
+  do {                                                     \
+    if constexpr (level >= COMPILED_LOG_LEVEL) {           \
+      Logger &tank_logger_ = Logger::instance();           \
+      if (tank_logger_.enabled(level))                     \
+        tank_logger_.log(t, level, msg, ##__VA_ARGS__);    \
+    }                                                      \
+  } while (0)
 
-#define LOG_INFO(t, msg) Logger::instance().log(t, LogLevel::INFO, msg)
-#define LOG_DEBUG(t, msg) Logger::instance().log(t, LogLevel::DEBUG, msg)
-#define LOG_ERROR(t, msg) Logger::instance().log(t, LogLevel::ERROR, msg)
+#define LOG_DEBUG(t, msg, ...) TANK_LOG(LogLevel::DEBUG, t, msg, ##__VA_ARGS__)
+#define LOG_INFO(t, msg, ...) TANK_LOG(LogLevel::INFO, t, msg, ##__VA_ARGS__)
+#define LOG_WARN(t, msg, ...) TANK_LOG(LogLevel::WARN, t, msg, ##__VA_ARGS__)
+#define LOG_ERROR(t, msg, ...) TANK_LOG(LogLevel::ERROR, t, msg, ##__VA_ARGS__)
 
 // Macro para registrar dados estatísticos
 #define LOG_METRIC(t, id, name, val) \
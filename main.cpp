@@ -6,8 +6,8 @@
 #define M_E 2.71828182845904523536
 #endif
 
+#include <filesystem>
 #include <iostream>
-#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,48 +15,37 @@
 #include "core/ChaosManager.h"  // Added ChaosManager
 #include "core/Config.h"        // Added Config
 #include "core/Simulator.h"
+#include "core/Snapshot.h"
+#include "core/Tracer.h"
 #include "events/SpecifiedTasksEvent.h"
 #include "events/TaskGenerationEvent.h"
 #include "logger.h"
 #include "metric.h"
-#include "model/FirstRemotePolicy.h"
-#include "model/IntelligentPolicy.h"
-#include "model/OffPolicy.h"
+#include "metric_columns.h"
+#include "model/MetricNames.h"
+#include "model/Policies.h"
 #include "model/RSU.h"
-#include "model/RandomPolicy.h"
 #include "model/Task.h"
+#include "model/TaskStore.h"
 #include "model/Vehicle.h"
 #include "utils/Rng.h"
 
 using std::cout, std::endl;
 
-std::shared_ptr<OffPolicy> create_policy(const std::string &name) {
-  if (name == "Random") return std::make_shared<RandomPolicy>();
-  if (name == "Intelligent") return std::make_shared<IntelligentPolicy>();
-  if (name == "FirstRemote") return std::make_shared<FirstRemotePolicy>();
-  return std::make_shared<OffPolicy>();  // Default: Local
-}
-
 std::string get_result_filename(const std::string &name, int seed) {
-  std::map<std::string, std::string> suffix = {{"Local", "local"},
-                                               {"Random", "random"},
-                                               {"Intelligent", "intelligent"},
-                                               {"FirstRemote", "first_remote"}};
-
-  std::string s = "local";
-  if (suffix.count(name)) s = suffix[name];
-  return "results/experiment_001_" + s + "_" + std::to_string(seed) + ".csv";
+  return "results/" + run_name(name, seed) + ".csv";
 }
 
 void calculate_scenario_entropy() {
-  double lambda = Config::TRAFFIC_LAMBDA;
+  const Config::Parameters &config = Config::get();
+  double lambda = config.TRAFFIC_LAMBDA;
 
   // ---------- Proper relative uncertainty (Static) ----------
   double U_arrival = (1.0 / lambda) / Config::REF_ARRIVAL_MAX_MEAN;
   double U_size =
-      (Config::TASK_MAX_SIZE - Config::TASK_MIN_SIZE) / Config::REF_SIZE_SPAN;
-  double U_density = Config::TASK_STD_DENSITY / Config::REF_DENSITY_STD_MAX;
-  double U_deadline = (Config::TASK_MAX_DEADLINE - Config::TASK_MIN_DEADLINE) /
+      (config.TASK_MAX_SIZE - config.TASK_MIN_SIZE) / Config::REF_SIZE_SPAN;
+  double U_density = config.TASK_STD_DENSITY / Config::REF_DENSITY_STD_MAX;
+  double U_deadline = (config.TASK_MAX_DEADLINE - config.TASK_MIN_DEADLINE) /
                       Config::REF_DEADLINE_SPAN;
 
   auto compress = [](double u) { return std::log(1.0 + u); };
@@ -73,10 +62,10 @@ void calculate_scenario_entropy() {
   // --------------------------------------------------
   double U_temporal = 0.0;
 
-  if (Config::FIELD_TOTAL_CHAOS) {
+  if (config.FIELD_TOTAL_CHAOS) {
     // Base non-stationarity from regime switching
-    double lambda_mean = Config::TRAFFIC_LAMBDA;
-    double lambda_var = Config::CHAOS_INTENSITY * lambda_mean * lambda_mean;
+    double lambda_mean = config.TRAFFIC_LAMBDA;
+    double lambda_var = config.CHAOS_INTENSITY * lambda_mean * lambda_mean;
 
     U_temporal += std::log(1.0 + lambda_var / (lambda_mean * lambda_mean));
 
@@ -86,7 +75,7 @@ void calculate_scenario_entropy() {
     U_temporal += shock_prob * std::log(1.0 + shock_magnitude);
 
     // Amplify by intensity
-    U_temporal *= Config::CHAOS_INTENSITY;
+    U_temporal *= config.CHAOS_INTENSITY;
   }
 
   double U_total = U_static + U_temporal;
@@ -107,6 +96,14 @@ int main(int argc, char **argv) {
   std::string policy_name = "Local";
   double duration = 100.0;
   int seed = 1978;
+  QueueKind queue_kind = QueueKind::BinaryHeap;
+  double tick = 0.0;  // seconds per clock tick, 0: continuous time
+  std::string checkpoint_file;  // snapshot written at checkpoint_at
+  double checkpoint_at = 0.0;
+  std::string resume_file;  // snapshot the run continues from
+  bool show_stats = false;  // engine counters after the run
+  std::string trace_file;   // Chrome trace of the run
+  bool binary_metrics = false;  // .mcol instead of .csv
 
   // ---------------------------------------------
   // First pass: parse flags
@@ -116,6 +113,34 @@ int main(int argc, char **argv) {
     if (arg == "--chaos") {
       Config::set_chaos_mode();
       std::cout << "!!! CHAOS MODE ACTIVATED !!!" << std::endl;
+    } else if (arg.rfind("--queue=", 0) == 0) {
+      if (!parse_queue_kind(arg.substr(8), queue_kind)) {
+        std::cerr << "Unknown queue '" << arg.substr(8)
+                  << "' (expected heap, calendar or radix)" << std::endl;
+        return 1;
+      }
+    } else if (arg.rfind("--tick=", 0) == 0) {
+      tick = std::stod(arg.substr(7));
+    } else if (arg.rfind("--checkpoint=", 0) == 0) {
+      // --checkpoint=FILE@T
+      std::string spec = arg.substr(13);
+      size_t at = spec.rfind('@');
+      if (at == std::string::npos) {
+        std::cerr << "Bad --checkpoint '" << spec << "' (expected FILE@TIME)"
+                  << std::endl;
+        return 1;
+      }
+      checkpoint_file = spec.substr(0, at);
+      checkpoint_at = std::stod(spec.substr(at + 1));
+    } else if (arg.rfind("--resume=", 0) == 0) {
+      resume_file = arg.substr(9);
+    } else if (arg == "--stats") {
+      show_stats = true;
+    } else if (arg == "--binary-metrics") {
+      binary_metrics = true;
+    } else if (arg.rfind("--trace=", 0) == 0) {
+      trace_file = arg.substr(8);
+      Tracer::enable();
     }
   }
 
@@ -143,26 +168,44 @@ int main(int argc, char **argv) {
   }
 
   // Set Global Seed (both main RNG and ChaosManager for reproducibility)
-  Rng::engine().seed(seed);
+  Rng::streams().seed(seed);
   ChaosManager::instance().seed(seed);
 
   cout << "Running experiment with Policy: " << policy_name
        << " | Duration: " << duration << " | Seed: " << seed << endl;
 
-  if (Config::FIELD_TOTAL_CHAOS) {
+  if (Config::get().FIELD_TOTAL_CHAOS) {
     cout << "Mode: NON-STATIONARY / ADVERSARIAL SCENARIO" << endl;
   }
 
   calculate_scenario_entropy();
 
-  Simulator sim;
+  Simulator sim(queue_kind);
+  sim.set_resolution(tick);
+  cout << "Event queue: " << queue_kind_name(queue_kind) << endl;
+  if (tick > 0.0) cout << "Clock tick: " << tick << "s" << endl;
   auto policy = create_policy(policy_name);
   std::string result_file = get_result_filename(policy_name, seed);
+  if (!resume_file.empty()) {
+    // Keep the output of the run that wrote the checkpoint
+    result_file.insert(result_file.size() - 4, "_resumed");
+  }
+  if (binary_metrics) result_file.replace(result_file.size() - 4, 4, ".mcol");
   cout << "Results will be saved to: " << result_file << endl;
+  // Trace per run, so concurrent runs do not share logs/simulation_trace.log
+  std::string trace_log =
+      "logs/" + std::filesystem::path(result_file).stem().string() + ".log";
+  Logger::instance().open(trace_log);
+  cout << "Trace log: " << trace_log << endl;
 
   MetricsHub::instance().clearListeners();
-  auto csvCollector = std::make_shared<CSVMetricsCollector>(result_file);
-  MetricsHub::instance().addListener(csvCollector);
+  std::shared_ptr<IMetricListener> collector;
+  if (binary_metrics) {
+    collector = std::make_shared<ColumnarMetricsCollector>(result_file);
+  } else {
+    collector = std::make_shared<CSVMetricsCollector>(result_file);
+  }
+  MetricsHub::instance().addListener(collector);
 
   std::vector<Vehicle::PtrVehicle> vehicles = {
       std::make_shared<Vehicle>(policy),
@@ -172,41 +215,83 @@ int main(int argc, char **argv) {
   std::vector<RSU::PtrRSU> rsus = {std::make_shared<RSU>()};
   for (auto r : rsus) {
     r->battery = Battery(10000.0);  // Set 10kJ battery
-    r->report_metric(sim, "BatteryRemaining", r->battery.get_remaining());
   }
-
   for (auto v : vehicles) {
     v->set_rsus(rsus);
     v->battery = Battery(10000.0);  // Set 10kJ battery
-    v->report_metric(sim, "BatteryRemaining", v->battery.get_remaining());
-    sim.schedule<TaskGenerationEvent>(1.0, v, Config::TRAFFIC_LAMBDA);
   }
 
-  sim.run(duration);
+  // Snapshot entity table: vehicles, then RSUs
+  std::vector<Model *> models;
+  for (auto v : vehicles) models.push_back(v.get());
+  for (auto r : rsus) models.push_back(r.get());
 
-  // === Temporal Chaos Validation ===
-  if (Config::FIELD_TOTAL_CHAOS) {
-    const auto &z = ChaosManager::instance().history();
+  if (resume_file.empty()) {
+    for (auto r : rsus) {
+      r->report_metric(sim, metrics::BatteryRemaining,
+                       r->battery.get_remaining());
+    }
+    for (auto v : vehicles) {
+      v->report_metric(sim, metrics::BatteryRemaining,
+                       v->battery.get_remaining());
+      sim.schedule<TaskGenerationEvent>(1.0, v, Config::get().TRAFFIC_LAMBDA);
+    }
+  } else {
+    TaskStore::of(sim);  // restored into
+    Snapshot::load(resume_file).restore(sim, models);
+    cout << "Resumed from " << resume_file << " at t=" << sim.now() << endl;
+  }
 
-    if (z.size() > 2) {
-      double num = 0.0;
-      double den = 0.0;
+  if (!checkpoint_file.empty() && checkpoint_at >= sim.now() &&
+      checkpoint_at < duration) {
+    sim.run(checkpoint_at);
+    Snapshot::capture(sim, models).save(checkpoint_file);
+    cout << "Checkpoint at t=" << checkpoint_at << " written to "
+         << checkpoint_file << endl;
+  }
+  sim.run(duration);
 
+  // === Temporal Chaos Validation ===
+  if (Config::get().FIELD_TOTAL_CHAOS) {
+    // The run's trajectory, as far as the busiest vehicle followed it
+    double num = 0.0;
+    double den = 0.0;
+    size_t samples = 0;
+
+    const std::vector<double> *longest = nullptr;
+    for (auto v : vehicles) {
+      const auto &z = v->get_chaos().history();
+      if (!longest || z.size() > longest->size()) longest = &z;
+    }
+    if (longest) {
+      const auto &z = *longest;
       for (size_t t = 1; t < z.size(); ++t) {
         num += z[t] * z[t - 1];
         den += z[t - 1] * z[t - 1];
       }
+      samples = z.size();
+    }
 
+    if (samples > 2) {
       double rho_hat = (den > 0.0) ? num / den : 0.0;
 
       cout << "---------------------------------------" << endl;
       cout << "Chaos Temporal Validation" << endl;
       cout << "Estimated AR(1) rho_hat = " << rho_hat << endl;
       cout << "Expected rho ≈ 0.9" << endl;
-      cout << "Samples collected = " << z.size() << endl;
+      cout << "Samples collected = " << samples << endl;
       cout << "---------------------------------------" << endl;
     }
   }
 
+  if (show_stats) sim.engine_stats().print(cout);
+  if (!trace_file.empty()) {
+    if (!Tracer::write(trace_file)) {
+      std::cerr << "Cannot write trace " << trace_file << std::endl;
+      return 1;
+    }
+    cout << "Trace written to " << trace_file << endl;
+  }
+
   return 0;
 }
@@ -1,25 +1,115 @@
 #ifndef METRIC_H
 #define METRIC_H
 
+#include <array>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-// Estrutura de dados pura para uma linha do CSV
+// Id de um nome de métrica, tag ou local "arquivo:linha" no MetricRegistry
+using MetricId = uint16_t;
+
+/**
+ * @brief Process-wide table of the strings metric records refer to
+ *
+ * Names, tags and source locations are registered once, on first use, and
+ * records carry their ids; resolving an id back with str() takes no lock.
+ * Id 0 is the empty string.
+ */
+class MetricRegistry {
+  static constexpr size_t CHUNK = 256;
+
+  struct Table {
+    std::mutex mtx;
+    std::unordered_map<std::string, MetricId> ids;
+    // Chunks never move: str() reads ids published under mtx without it
+    std::array<std::unique_ptr<std::string[]>, (1 << 16) / CHUNK> chunks;
+    size_t size = 0;
+  };
+
+  struct SiteHash {
+    size_t operator()(const std::pair<const char *, int> &site) const {
+      return std::hash<const char *>()(site.first) ^
+             (static_cast<size_t>(site.second) * 0x9e3779b97f4a7c15ull);
+    }
+  };
+
+  static Table &table() {
+    static Table *t = [] {
+      auto *table = new Table;  // never destroyed: ids outlive listeners
+      intern_locked(*table, "");
+      return table;
+    }();
+    return *t;
+  }
+
+  static MetricId intern_locked(Table &t, const std::string &s) {
+    auto it = t.ids.find(s);
+    if (it != t.ids.end()) return it->second;
+    if (t.size == CHUNK * t.chunks.size()) {
+      throw std::runtime_error("MetricRegistry: more than 65536 strings");
+    }
+    auto &chunk = t.chunks[t.size / CHUNK];
+    if (!chunk) chunk.reset(new std::string[CHUNK]);
+    chunk[t.size % CHUNK] = s;
+    auto id = static_cast<MetricId>(t.size++);
+    t.ids.emplace(s, id);
+    return id;
+  }
+
+ public:
+  static constexpr MetricId EMPTY = 0;
+
+  static MetricId intern(const std::string &s) {
+    Table &t = table();
+    std::lock_guard<std::mutex> lock(t.mtx);
+    return intern_locked(t, s);
+  }
+
+  // Id of "file:line"; file must be a literal (as from __builtin_FILE()),
+  // its address is the key of a per-thread cache
+  static MetricId location(const char *file, int line) {
+    thread_local std::unordered_map<std::pair<const char *, int>, MetricId,
+                                    SiteHash>
+        sites;
+    auto it = sites.find({file, line});
+    if (it != sites.end()) return it->second;
+    MetricId id = intern(std::string(file) + ":" + std::to_string(line));
+    sites.emplace(std::make_pair(file, line), id);
+    return id;
+  }
+
+  static const std::string &str(MetricId id) {
+    return table().chunks[id / CHUNK][id % CHUNK];
+  }
+};
+
+// Estrutura de dados pura para uma linha do CSV: só valores e ids, cópia
+// trivial (sem alocação por métrica)
 struct MetricRecord {
   double time;
-  int entity_id;
-  std::string metric_name;
   double value;
+  int64_t task_id;
+  int entity_id;
+  MetricId metric;
   // Opcional: Tags extras (ex: "Local", "Offload")
-  std::string tag;
-  int task_id;
-  std::string file;
-  int line;
+  MetricId tag;
+  MetricId location;  // "arquivo:linha"
+
+  const std::string &metric_name() const { return MetricRegistry::str(metric); }
+  const std::string &tag_name() const { return MetricRegistry::str(tag); }
+  const std::string &location_name() const {
+    return MetricRegistry::str(location);
+  }
 };
 
 // Interface do Listener (O "Contrato")
@@ -57,9 +147,9 @@ class CSVMetricsCollector : public IMetricListener {
     if (buffer.empty()) return;
     std::ofstream file(filename, std::ios::out | std::ios::app);
     for (const auto &rec : buffer) {
-      file << rec.time << "," << rec.entity_id << "," << rec.metric_name << ","
-           << rec.value << "," << rec.tag << "," << rec.task_id << ","
-           << rec.file << ":" << rec.line << "\n";
+      file << rec.time << "," << rec.entity_id << "," << rec.metric_name()
+           << "," << rec.value << "," << rec.tag_name() << "," << rec.task_id
+           << "," << rec.location_name() << "\n";
     }
     buffer.clear();
   }
@@ -69,10 +159,44 @@ class CSVMetricsCollector : public IMetricListener {
 class MetricsHub {
   std::vector<std::shared_ptr<IMetricListener>> listeners;
 
+  static std::vector<MetricRecord> *&bound() {
+    static thread_local std::vector<MetricRecord> *buffer = nullptr;
+    return buffer;
+  }
+
+  static MetricsHub *&bound_hub() {
+    static thread_local MetricsHub *hub = nullptr;
+    return hub;
+  }
+
  public:
   static MetricsHub &instance() {
     static MetricsHub hub;
-    return hub;
+    MetricsHub *b = bound_hub();
+    return b ? *b : hub;
+  }
+
+  // Route instance() of the calling thread to the hub of a SimContext (or
+  // back to the process-wide one with nullptr); returns the previous binding
+  static MetricsHub *bind(MetricsHub *hub) {
+    MetricsHub *previous = bound_hub();
+    bound_hub() = hub;
+    return previous;
+  }
+
+  // Partitions of a parallel run buffer their records on the calling thread;
+  // ParallelSimulator merges them in time order and calls dispatch()
+  static std::vector<MetricRecord> *bind_buffer(
+      std::vector<MetricRecord> *buffer) {
+    std::vector<MetricRecord> *previous = bound();
+    bound() = buffer;
+    return previous;
+  }
+
+  void dispatch(const MetricRecord &rec) {
+    for (auto &l : listeners) {
+      l->onMetricRecorded(rec);
+    }
   }
 
   void addListener(std::shared_ptr<IMetricListener> listener) {
@@ -81,17 +205,27 @@ class MetricsHub {
 
   void clearListeners() { listeners.clear(); }
 
+  void record(double time, int entity_id, MetricId name, double value,
+              MetricId tag, int64_t task_id, MetricId location) {
+    MetricRecord rec{time, value, task_id, entity_id, name, tag, location};
+    if (std::vector<MetricRecord> *buffer = bound()) {
+      buffer->push_back(rec);
+      return;
+    }
+    dispatch(rec);
+  }
+
+  // Registers name and tag on the way (takes the registry lock)
   void record(double time, int entity_id, const std::string &name, double value,
-              const std::string &tag, int task_id, const std::string &file,
+              const std::string &tag, int64_t task_id, const char *file,
               int line) {
-    MetricRecord rec{time, entity_id, name, value, tag, task_id, file, line};
-    for (auto &l : listeners) {
-      l->onMetricRecorded(rec);
-    }
+    record(time, entity_id, MetricRegistry::intern(name), value,
+           MetricRegistry::intern(tag), task_id,
+           MetricRegistry::location(file, line));
   }
 
   void record(double time, int entity_id, const std::string &name, double value,
-              const std::string &tag, const std::string &file, int line) {
+              const std::string &tag, const char *file, int line) {
     record(time, entity_id, name, value, tag, -1, file, line);
   }
 };
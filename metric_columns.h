@@ -0,0 +1,265 @@
+#ifndef METRIC_COLUMNS_H
+#define METRIC_COLUMNS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "metric.h"
+
+/**
+ * Binary, column-oriented metric files (.mcol)
+ *
+ * File: "TANKMCOL", uint32 version, then blocks until the end of the file.
+ * Block: uint32 rows, uint32 new_strings, double min_time, double max_time,
+ * uint64 payload bytes; then the new dictionary strings (uint32 length +
+ * bytes, ids continuing from the previous block) and the columns, each
+ * `rows` values wide:
+ *   time double | entity int32 | metric uint16 | value double | tag uint16 |
+ *   task int64 | location uint16
+ * metric, tag and location ("file:line") are ids in the string dictionary.
+ * Values are stored in host byte order; the payload size lets a reader skip
+ * blocks outside a time range without decoding them.
+ */
+namespace metric_columns {
+
+inline const char MAGIC[8] = {'T', 'A', 'N', 'K', 'M', 'C', 'O', 'L'};
+constexpr uint32_t VERSION = 2;
+
+using StringId = uint16_t;
+
+// Column bytes of one row
+constexpr uint64_t ROW_BYTES = 2 * sizeof(double) + sizeof(int32_t) +
+                               sizeof(int64_t) + 3 * sizeof(StringId);
+
+}  // namespace metric_columns
+
+/**
+ * @brief Columns of one block, dictionary ids resolved by the reader
+ */
+struct MetricBlock {
+  double min_time = 0.0;
+  double max_time = 0.0;
+  std::vector<double> time;
+  std::vector<int32_t> entity;
+  std::vector<metric_columns::StringId> metric;
+  std::vector<double> value;
+  std::vector<metric_columns::StringId> tag;
+  std::vector<int64_t> task;
+  std::vector<metric_columns::StringId> location;
+
+  size_t rows() const { return time.size(); }
+  void clear() {
+    time.clear();
+    entity.clear();
+    metric.clear();
+    value.clear();
+    tag.clear();
+    task.clear();
+    location.clear();
+  }
+};
+
+// Writes .mcol through one file handle kept open for the whole run
+class ColumnarMetricsCollector : public IMetricListener {
+  std::ofstream file;
+  MetricBlock block;
+  // MetricRegistry id -> file dictionary id + 1 (0: not written yet)
+  std::vector<uint32_t> ids;
+  uint32_t dictionary_size = 0;
+  std::vector<std::string> new_strings;  // since the last block
+  std::mutex mtx;
+  const size_t BLOCK_ROWS = 8192;
+
+  metric_columns::StringId intern(MetricId id) {
+    if (id >= ids.size()) ids.resize(id + 1, 0);
+    if (ids[id] == 0) {
+      new_strings.push_back(MetricRegistry::str(id));
+      ids[id] = ++dictionary_size;
+    }
+    return static_cast<metric_columns::StringId>(ids[id] - 1);
+  }
+
+  template <typename T>
+  void put(const T &v) {
+    file.write(reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  template <typename T>
+  void put(const std::vector<T> &column) {
+    file.write(reinterpret_cast<const char *>(column.data()),
+               static_cast<std::streamsize>(column.size() * sizeof(T)));
+  }
+
+  // Caller holds mtx
+  void write_block() {
+    if (block.rows() == 0) return;
+    uint64_t payload = block.rows() * metric_columns::ROW_BYTES;
+    for (const auto &s : new_strings) payload += sizeof(uint32_t) + s.size();
+    put(static_cast<uint32_t>(block.rows()));
+    put(static_cast<uint32_t>(new_strings.size()));
+    put(block.min_time);
+    put(block.max_time);
+    put(payload);
+    for (const auto &s : new_strings) {
+      put(static_cast<uint32_t>(s.size()));
+      file.write(s.data(), static_cast<std::streamsize>(s.size()));
+    }
+    put(block.time);
+    put(block.entity);
+    put(block.metric);
+    put(block.value);
+    put(block.tag);
+    put(block.task);
+    put(block.location);
+    new_strings.clear();
+    block.clear();
+  }
+
+ public:
+  explicit ColumnarMetricsCollector(const std::string &fname)
+      : file(fname, std::ios::out | std::ios::binary | std::ios::trunc) {
+    if (!file) {
+      throw std::runtime_error("ColumnarMetricsCollector: cannot open " +
+                               fname);
+    }
+    file.write(metric_columns::MAGIC, sizeof(metric_columns::MAGIC));
+    put(metric_columns::VERSION);
+  }
+
+  ~ColumnarMetricsCollector() { flush(); }
+
+  void onMetricRecorded(const MetricRecord &record) override {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (block.rows() == 0) {
+      block.min_time = block.max_time = record.time;
+    } else {
+      block.min_time = std::min(block.min_time, record.time);
+      block.max_time = std::max(block.max_time, record.time);
+    }
+    block.time.push_back(record.time);
+    block.entity.push_back(record.entity_id);
+    block.metric.push_back(intern(record.metric));
+    block.value.push_back(record.value);
+    block.tag.push_back(intern(record.tag));
+    block.task.push_back(record.task_id);
+    block.location.push_back(intern(record.location));
+    if (block.rows() >= BLOCK_ROWS) write_block();
+  }
+
+  // Writes the pending rows as a (short) block
+  void flush() {
+    std::lock_guard<std::mutex> lock(mtx);
+    write_block();
+    file.flush();
+  }
+};
+
+// Reads .mcol block by block; columns are read straight into the vectors
+class ColumnarMetricsReader {
+  std::ifstream file;
+  std::string path;
+  std::vector<std::string> strings;
+  uint64_t size = 0;  // of the file, bounds what a header may announce
+
+  template <typename T>
+  void get(T &v) {
+    file.read(reinterpret_cast<char *>(&v), sizeof(T));
+  }
+
+  template <typename T>
+  void get(std::vector<T> &column, size_t rows) {
+    column.resize(rows);
+    file.read(reinterpret_cast<char *>(column.data()),
+              static_cast<std::streamsize>(rows * sizeof(T)));
+  }
+
+  [[noreturn]] void corrupt() const {
+    throw std::runtime_error("ColumnarMetricsReader: " + path +
+                             " is truncated or not a metrics file");
+  }
+
+ public:
+  explicit ColumnarMetricsReader(const std::string &fname)
+      : file(fname, std::ios::in | std::ios::binary), path(fname) {
+    char magic[sizeof(metric_columns::MAGIC)] = {};
+    uint32_t version = 0;
+    file.read(magic, sizeof(magic));
+    get(version);
+    if (!file ||
+        !std::equal(magic, magic + sizeof(magic), metric_columns::MAGIC) ||
+        version != metric_columns::VERSION) {
+      corrupt();
+    }
+    std::streamoff header = file.tellg();
+    file.seekg(0, std::ios::end);
+    size = static_cast<uint64_t>(file.tellg());
+    file.seekg(header);
+  }
+
+  // Next block overlapping [from, to] (every block by default); false at
+  // the end of the file. Skipped blocks still extend the dictionary.
+  bool next(MetricBlock &block,
+            double from = -std::numeric_limits<double>::infinity(),
+            double to = std::numeric_limits<double>::infinity()) {
+    for (;;) {
+      uint32_t rows = 0, new_strings = 0;
+      uint64_t payload = 0;
+      get(rows);
+      if (file.gcount() == 0) return false;  // clean end between blocks
+      if (!file) corrupt();
+      get(new_strings);
+      get(block.min_time);
+      get(block.max_time);
+      get(payload);
+      if (!file || payload > size - static_cast<uint64_t>(file.tellg())) {
+        corrupt();
+      }
+      // Nothing is allocated beyond what the payload announces
+      uint64_t dictionary = 0;
+      for (uint32_t i = 0; i < new_strings; ++i) {
+        uint32_t length = 0;
+        get(length);
+        dictionary += sizeof(uint32_t);
+        if (!file || dictionary > payload || length > payload - dictionary) {
+          corrupt();
+        }
+        std::string s(length, '\0');
+        file.read(s.data(), length);
+        strings.push_back(std::move(s));
+        dictionary += length;
+      }
+      if (!file || rows * metric_columns::ROW_BYTES != payload - dictionary) {
+        corrupt();
+      }
+      if (block.max_time < from || block.min_time > to) {
+        file.seekg(static_cast<std::streamoff>(payload - dictionary),
+                   std::ios::cur);
+        continue;
+      }
+      get(block.time, rows);
+      get(block.entity, rows);
+      get(block.metric, rows);
+      get(block.value, rows);
+      get(block.tag, rows);
+      get(block.task, rows);
+      get(block.location, rows);
+      if (!file) corrupt();
+      return true;
+    }
+  }
+
+  // Strings seen so far, indexed by the ids of the metric/tag/location
+  // columns
+  const std::vector<std::string> &dictionary() const { return strings; }
+  const std::string &string(metric_columns::StringId id) const {
+    return strings.at(id);
+  }
+};
+
+#endif  // METRIC_COLUMNS_H
@@ -0,0 +1,308 @@
+#ifndef METRIC_STATS_H
+#define METRIC_STATS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "metric.h"
+
+/**
+ * @brief Count, sum, mean, variance (Welford), min, max and last value of a
+ * stream of samples; merge() combines two streams exactly (Chan et al.)
+ */
+struct RunningStats {
+  uint64_t count = 0;
+  double sum = 0.0;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  double last = 0.0;  // in add() order; a merged stream keeps the other's
+
+  void add(double x) {
+    ++count;
+    sum += x;
+    double delta = x - running_mean;
+    running_mean += delta / count;
+    m2 += delta * (x - running_mean);
+    min = std::min(min, x);
+    max = std::max(max, x);
+    last = x;
+  }
+
+  void merge(const RunningStats &other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+      *this = other;
+      return;
+    }
+    uint64_t n = count + other.count;
+    double delta = other.running_mean - running_mean;
+    m2 += other.m2 + delta * delta * count * other.count / n;
+    running_mean += delta * other.count / n;
+    count = n;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    last = other.last;
+  }
+
+  double mean() const { return count ? sum / count : 0.0; }
+  // Sample variance
+  double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+  double stddev() const { return std::sqrt(variance()); }
+
+ private:
+  double running_mean = 0.0;
+  double m2 = 0.0;
+};
+
+/**
+ * @brief Mergeable quantile sketch with relative accuracy
+ *
+ * Values fall in logarithmic buckets gamma^(i-1) < |x| <= gamma^i with
+ * gamma = (1 + accuracy) / (1 - accuracy), so any quantile is returned
+ * within `accuracy` relative error of the exact one, in memory that grows
+ * with the value range rather than the sample count (DDSketch). Sketches
+ * with the same accuracy merge by adding bucket counts, with no extra error.
+ */
+class QuantileSketch {
+  double accuracy;
+  double log_gamma;
+  std::map<int, uint64_t> positive;
+  std::map<int, uint64_t> negative;  // by the bucket of -x
+  uint64_t zeros = 0;
+  uint64_t n = 0;
+  double lo = std::numeric_limits<double>::infinity();
+  double hi = -std::numeric_limits<double>::infinity();
+
+  static constexpr double MIN_MAGNITUDE = 1e-12;  // smaller counts as zero
+
+  int bucket(double magnitude) const {
+    return static_cast<int>(std::ceil(std::log(magnitude) / log_gamma));
+  }
+  double value(int index) const {
+    // Midpoint of the bucket in relative terms
+    double gamma = std::exp(log_gamma);
+    return 2.0 * std::exp(index * log_gamma) / (gamma + 1.0);
+  }
+
+ public:
+  explicit QuantileSketch(double accuracy_ = 0.01)
+      : accuracy(accuracy_),
+        log_gamma(std::log((1.0 + accuracy_) / (1.0 - accuracy_))) {
+    if (!(accuracy_ > 0.0 && accuracy_ < 1.0)) {
+      throw std::invalid_argument("QuantileSketch: accuracy not in (0, 1)");
+    }
+  }
+
+  void add(double x) {
+    if (x > MIN_MAGNITUDE) {
+      ++positive[bucket(x)];
+    } else if (x < -MIN_MAGNITUDE) {
+      ++negative[bucket(-x)];
+    } else {
+      ++zeros;
+    }
+    ++n;
+    lo = std::min(lo, x);
+    hi = std::max(hi, x);
+  }
+
+  void merge(const QuantileSketch &other) {
+    if (other.accuracy != accuracy) {
+      throw std::invalid_argument("QuantileSketch: different accuracies");
+    }
+    for (const auto &[i, c] : other.positive) positive[i] += c;
+    for (const auto &[i, c] : other.negative) negative[i] += c;
+    zeros += other.zeros;
+    n += other.n;
+    lo = std::min(lo, other.lo);
+    hi = std::max(hi, other.hi);
+  }
+
+  uint64_t count() const { return n; }
+  double relative_accuracy() const { return accuracy; }
+
+  // Value of rank floor(q * count) in ascending order (0 when empty)
+  double quantile(double q) const {
+    if (n == 0) return 0.0;
+    q = std::clamp(q, 0.0, 1.0);
+    uint64_t rank = std::min<uint64_t>(static_cast<uint64_t>(q * n), n - 1);
+    // Negative values from the largest magnitude, zeros, positive values
+    uint64_t seen = 0;
+    for (auto it = negative.rbegin(); it != negative.rend(); ++it) {
+      seen += it->second;
+      if (seen > rank) return std::clamp(-value(it->first), lo, hi);
+    }
+    seen += zeros;
+    if (seen > rank) return std::clamp(0.0, lo, hi);
+    for (const auto &[i, c] : positive) {
+      seen += c;
+      if (seen > rank) return std::clamp(value(i), lo, hi);
+    }
+    return hi;
+  }
+};
+
+/**
+ * @brief Running statistics, quantiles and a time-binned series of one
+ * metric (or one metric of one entity or tag)
+ */
+struct MetricSummary {
+  RunningStats stats;
+  QuantileSketch sketch;
+  // floor(time / bin width) -> statistics of the values recorded in the bin
+  std::map<int64_t, RunningStats> series;
+
+  void add(double time, double value, double bin_width) {
+    stats.add(value);
+    sketch.add(value);
+    series[static_cast<int64_t>(std::floor(time / bin_width))].add(value);
+  }
+
+  void merge(const MetricSummary &other) {
+    stats.merge(other.stats);
+    sketch.merge(other.sketch);
+    for (const auto &[bin, s] : other.series) series[bin].merge(s);
+  }
+
+  double quantile(double q) const { return sketch.quantile(q); }
+};
+
+/**
+ * @brief Listener that summarizes the metric stream as it is recorded
+ *
+ * Keeps a MetricSummary per metric and RunningStats per (metric, entity) and
+ * per (metric, tag), so a tool reads success rates, latency percentiles or
+ * energy totals from it once run() returns instead of writing the records to
+ * a file and parsing them back. Quantiles and series per entity and per tag
+ * cost a map update each per record, so they are kept only when `detailed`.
+ * Summaries of replicas (same bin width and detail) merge into pooled ones.
+ */
+class MetricStatistics : public IMetricListener {
+  using Summaries = std::unordered_map<uint64_t, MetricSummary>;
+  using Stats = std::unordered_map<uint64_t, RunningStats>;
+
+  double bin_width;
+  bool detailed;
+  Summaries by_metric;
+  Stats by_entity;  // when not detailed
+  Stats by_tag;
+  Summaries entity_detail;  // when detailed
+  Summaries tag_detail;
+  std::mutex mtx;
+
+  static uint64_t entity_key(MetricId name, int entity_id) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(entity_id)) << 16 |
+           name;
+  }
+  static uint64_t tag_key(MetricId name, MetricId tag) {
+    return static_cast<uint64_t>(tag) << 16 | name;
+  }
+
+  template <typename Map>
+  static const typename Map::mapped_type *find(const Map &map, uint64_t key) {
+    auto it = map.find(key);
+    return it == map.end() ? nullptr : &it->second;
+  }
+  const RunningStats *stats(const Stats &plain, const Summaries &detail,
+                            uint64_t key) const {
+    if (!detailed) return find(plain, key);
+    const MetricSummary *s = find(detail, key);
+    return s ? &s->stats : nullptr;
+  }
+
+  template <typename Map>
+  static void merge(Map &into, const Map &from) {
+    for (const auto &[key, summary] : from) into[key].merge(summary);
+  }
+  void merge_maps(const Summaries &metrics, const Stats &entity_stats,
+                  const Stats &tag_stats, const Summaries &entities,
+                  const Summaries &tags) {
+    merge(by_metric, metrics);
+    merge(by_entity, entity_stats);
+    merge(by_tag, tag_stats);
+    merge(entity_detail, entities);
+    merge(tag_detail, tags);
+  }
+
+ public:
+  explicit MetricStatistics(double bin_width_ = 1.0, bool detailed_ = false)
+      : bin_width(bin_width_), detailed(detailed_) {
+    if (!(bin_width_ > 0.0)) {
+      throw std::invalid_argument("MetricStatistics: bin width must be > 0");
+    }
+  }
+
+  void onMetricRecorded(const MetricRecord &record) override {
+    uint64_t entity = entity_key(record.metric, record.entity_id);
+    uint64_t tag = tag_key(record.metric, record.tag);
+    std::lock_guard<std::mutex> lock(mtx);
+    by_metric[record.metric].add(record.time, record.value, bin_width);
+    if (detailed) {
+      entity_detail[entity].add(record.time, record.value, bin_width);
+      tag_detail[tag].add(record.time, record.value, bin_width);
+    } else {
+      by_entity[entity].add(record.value);
+      by_tag[tag].add(record.value);
+    }
+  }
+
+  // Summaries, nullptr when nothing was recorded under the key (or, for the
+  // *_summary accessors, when not detailed). Read them once the run is over
+  // (they are not locked).
+  const MetricSummary *metric(MetricId name) const {
+    return find(by_metric, name);
+  }
+  const RunningStats *entity(MetricId name, int entity_id) const {
+    return stats(by_entity, entity_detail, entity_key(name, entity_id));
+  }
+  const RunningStats *tag(MetricId name, MetricId tag) const {
+    return stats(by_tag, tag_detail, tag_key(name, tag));
+  }
+  const MetricSummary *entity_summary(MetricId name, int entity_id) const {
+    return find(entity_detail, entity_key(name, entity_id));
+  }
+  const MetricSummary *tag_summary(MetricId name, MetricId tag) const {
+    return find(tag_detail, tag_key(name, tag));
+  }
+
+  // Metrics recorded so far, in id order
+  std::vector<MetricId> metrics() const {
+    std::vector<MetricId> ids;
+    for (const auto &entry : by_metric) {
+      ids.push_back(static_cast<MetricId>(entry.first));
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+
+  double bin() const { return bin_width; }
+  bool is_detailed() const { return detailed; }
+
+  void merge(const MetricStatistics &other) {
+    if (other.bin_width != bin_width || other.detailed != detailed) {
+      throw std::invalid_argument(
+          "MetricStatistics: different bin widths or detail");
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    if (&other == this) {
+      // Merging a map into itself would insert into it while iterating it
+      Summaries metrics = by_metric, entities = entity_detail,
+                tags = tag_detail;
+      Stats entity_stats = by_entity, tag_stats = by_tag;
+      merge_maps(metrics, entity_stats, tag_stats, entities, tags);
+      return;
+    }
+    merge_maps(other.by_metric, other.by_entity, other.by_tag,
+               other.entity_detail, other.tag_detail);
+  }
+};
+
+#endif  // METRIC_STATS_H
@@ -1,12 +1,12 @@
 #include "CPU.h"
 
-#include "../core/ChaosManager.h"
+#include "../core/Config.h"
+#include "../utils/Rng.h"
 
-double CPU::processing_time(Task::PtrTask task) {
-  double result = task->total_cycles() / freq_mhz;
-  if (Config::FIELD_TOTAL_CHAOS) {
-    double drift = ChaosManager::instance().get_state();
-    return Rng::pdrift(result, drift);
+double CPU::processing_time(const Task &task) {
+  double result = task.total_cycles() / freq_mhz;
+  if (Config::get().FIELD_TOTAL_CHAOS) {
+    return Rng::pdrift(result, task.get_drift());
   }
   return result;
 }
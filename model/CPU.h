@@ -10,7 +10,7 @@ class CPU {
   double freq_mhz = 1.18 * 1e9;
 
  public:
-  virtual double processing_time(Task::PtrTask task);
+  virtual double processing_time(const Task &task);
   void complete() { current_state = CPUState::Idle; }
   void start() { current_state = CPUState::Busy; }
   bool is_idle() const { return current_state == CPUState::Idle; }
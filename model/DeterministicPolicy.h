@@ -44,7 +44,7 @@ struct ScriptedDecision {
 class DeterministicPolicy : public OffPolicy {
  public:
   using DecisionScript =
-      std::map<int, ScriptedDecision>;  // task_id -> decision
+      std::map<int64_t, ScriptedDecision>;  // task_id -> decision
 
   DeterministicPolicy() { name = "DeterministicPolicy"; }
 
@@ -59,7 +59,7 @@ class DeterministicPolicy : public OffPolicy {
    * @param task_id The task ID
    * @param decision The decision (Local or Remote with RSU index)
    */
-  void add_decision(int task_id, ScriptedDecision decision) {
+  void add_decision(int64_t task_id, ScriptedDecision decision) {
     decisions_[task_id] = decision;
   }
 
@@ -96,9 +96,9 @@ class DeterministicPolicy : public OffPolicy {
    * @brief Make decision based on script
    * Falls back to Local if task_id not in script
    */
-  DecisionResult decide(Task::PtrTask task,
+  DecisionResult decide(const Task &task,
                         std::vector<RSU::PtrRSU> &rsus) override {
-    int task_id = task->get_id();
+    int64_t task_id = task.get_id();
 
     // Lookup in script
     auto it = decisions_.find(task_id);
@@ -131,7 +131,7 @@ class DeterministicPolicy : public OffPolicy {
    * @brief Decision time for deterministic policy
    * Minimal time since decision is pre-computed
    */
-  double decision_time(Task::PtrTask task) override {
+  double decision_time(const Task &task) override {
     return 0.001;  // 1ms - essentially instant lookup
   }
 
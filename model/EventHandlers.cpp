@@ -0,0 +1,27 @@
+#include "../core/EventType.h"
+#include "Vehicle.h"
+
+// Fills the engine's dispatch table with the model event handlers
+namespace {
+bool register_handlers() {
+  register_event_handler(EventType::OnDecisionStart,
+                         [](Model &m, Simulator &sim) {
+                           static_cast<Vehicle &>(m).onDecisionStart(sim);
+                         });
+  register_event_handler(EventType::OnDecisionComplete,
+                         [](Model &m, Simulator &sim) {
+                           static_cast<Vehicle &>(m).onDecisionComplete(sim);
+                         });
+  register_event_handler(EventType::OnProcessingStart,
+                         [](Model &m, Simulator &sim) {
+                           m.OnProcessingStart(sim);
+                         });
+  register_event_handler(EventType::OnProcessingComplete,
+                         [](Model &m, Simulator &sim) {
+                           m.OnProcessingComplete(sim);
+                         });
+  return true;
+}
+
+const bool registered = register_handlers();
+}  // namespace
@@ -1,11 +0,0 @@
-#ifndef EVENTTYPE_H
-#define EVENTTYPE_H
-
-enum class EventType {
-  OnDecisionStart,
-  OnDecisionComplete,
-  OnProcessingStart,
-  OnProcessingComplete,
-};
-
-#endif  // EVENTTYPE_H
@@ -3,7 +3,7 @@
 #include "../core/ChaosManager.h"
 #include "Model.h"
 
-DecisionResult FirstRemotePolicy::decide(Task::PtrTask task,
+DecisionResult FirstRemotePolicy::decide(const Task &task,
                                          std::vector<RSU::PtrRSU> &rsus) {
   DecisionType dt = DecisionType::Local;
   RSU::PtrRSU dst = nullptr;
@@ -13,9 +13,9 @@ DecisionResult FirstRemotePolicy::decide(Task::PtrTask task,
   return {dt, dst};
 }
 
-double FirstRemotePolicy::decision_time(Task::PtrTask task) {
-  double result = Rng::uniform(0.003, 0.005);  // 3–5ms
-  if (Config::FIELD_TOTAL_CHAOS) {
+double FirstRemotePolicy::decision_time(const Task &task) {
+  double result = Rng::uniform(Rng::DECISION, 0.003, 0.005);  // 3–5ms
+  if (Config::get().FIELD_TOTAL_CHAOS) {
     double drift = ChaosManager::instance().get_state();
     return Rng::pdrift(result, drift);
   }
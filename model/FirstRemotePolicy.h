@@ -6,9 +6,9 @@
 class FirstRemotePolicy : public OffPolicy {
  public:
   FirstRemotePolicy() : OffPolicy() { name = "FirstRemotePolicy"; }
-  DecisionResult decide(Task::PtrTask task,
+  DecisionResult decide(const Task &task,
                         std::vector<RSU::PtrRSU>& rsus) override;
-  double decision_time(Task::PtrTask task) override;
+  double decision_time(const Task &task) override;
 };
 
 #endif  // FIRSTREMOTEPOLICY_H
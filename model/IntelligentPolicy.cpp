@@ -3,7 +3,7 @@
 #include "../core/ChaosManager.h"
 #include "Model.h"
 
-DecisionResult IntelligentPolicy::decide(Task::PtrTask task,
+DecisionResult IntelligentPolicy::decide(const Task &task,
                                          std::vector<RSU::PtrRSU> &rsus) {
   if (!host) return {DecisionType::Local, nullptr};
 
@@ -12,7 +12,7 @@ DecisionResult IntelligentPolicy::decide(Task::PtrTask task,
   // 1. Estimativa Realista de Tempo Local (Wait Time + Service Time)
   // Assumindo que tasks na fila têm tamanho médio similar ou somando seus
   // ciclos se acessível
-  double service_time = task->total_cycles() / host->cpu.get_freq();
+  double service_time = task.total_cycles() / host->cpu.get_freq();
 
   // Estima quanto tempo a fila atual vai levar para esvaziar
   // Se você não tem acesso aos ciclos das tasks na fila, use uma média
@@ -22,7 +22,7 @@ DecisionResult IntelligentPolicy::decide(Task::PtrTask task,
 
   // 2. Decisão Baseada em Deadline (Agora considerando a espera)
   // Adicionamos uma margem de segurança (ex: 10%)
-  if (total_local_time > (task->get_deadline() * 0.90)) {
+  if (total_local_time > (task.get_deadline() * 0.90)) {
     if (!rsus.empty()) {
       // Lógica Best-Fit (Reutilizada para ambos os casos)
       RSU::PtrRSU best_rsu = nullptr;
@@ -47,10 +47,10 @@ DecisionResult IntelligentPolicy::decide(Task::PtrTask task,
   return {DecisionType::Local, nullptr};
 }
 
-double IntelligentPolicy::decision_time(Task::PtrTask task) {
+double IntelligentPolicy::decision_time(const Task &task) {
   // Custo ligeiramente maior que Random pois faz cálculos (1ms a mais simulado)
-  double result = Rng::uniform(0.004, 0.006);  // 4–6ms
-  if (Config::FIELD_TOTAL_CHAOS) {
+  double result = Rng::uniform(Rng::DECISION, 0.004, 0.006);  // 4–6ms
+  if (Config::get().FIELD_TOTAL_CHAOS) {
     double drift = ChaosManager::instance().get_state();
     return Rng::pdrift(result, drift);
   }
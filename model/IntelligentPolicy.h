@@ -9,9 +9,9 @@ class IntelligentPolicy : public OffPolicy {
  public:
   IntelligentPolicy() : OffPolicy() { name = "IntelligentPolicy"; }
 
-  DecisionResult decide(Task::PtrTask task,
+  DecisionResult decide(const Task &task,
                         std::vector<RSU::PtrRSU>& rsus) override;
-  double decision_time(Task::PtrTask task) override;
+  double decision_time(const Task &task) override;
 };
 
 #endif  // INTELLIGENTPOLICY_H
@@ -0,0 +1,47 @@
+#ifndef METRICNAMES_H
+#define METRICNAMES_H
+
+#include "../metric.h"
+
+// Metrics and tags reported by the models, registered once at start-up so
+// report_metric() passes ids instead of building strings
+namespace metrics {
+
+inline const MetricId BandwidthDrop = MetricRegistry::intern("BandwidthDrop");
+inline const MetricId BatteryDepleted =
+    MetricRegistry::intern("BatteryDepleted");
+inline const MetricId BatteryRemaining =
+    MetricRegistry::intern("BatteryRemaining");
+inline const MetricId CpuEnergy = MetricRegistry::intern("CpuEnergy");
+inline const MetricId EnergyConsumption =
+    MetricRegistry::intern("EnergyConsumption");
+inline const MetricId FullQueueError = MetricRegistry::intern("FullQueueError");
+inline const MetricId LowEnergyFail = MetricRegistry::intern("LowEnergyFail");
+inline const MetricId OffloadingType = MetricRegistry::intern("OffloadingType");
+inline const MetricId QueueSizeDecision =
+    MetricRegistry::intern("QueueSize_Decision");
+inline const MetricId QueueSizeProcessing =
+    MetricRegistry::intern("QueueSize_Processing");
+inline const MetricId TaskLatency = MetricRegistry::intern("TaskLatency");
+inline const MetricId TaskMargin = MetricRegistry::intern("TaskMargin");
+inline const MetricId TaskSuccess = MetricRegistry::intern("TaskSuccess");
+inline const MetricId TaskTotalCycles =
+    MetricRegistry::intern("TaskTotalCycles");
+inline const MetricId TransferTime = MetricRegistry::intern("TransferTime");
+inline const MetricId TxEnergy = MetricRegistry::intern("TxEnergy");
+
+}  // namespace metrics
+
+namespace metric_tags {
+
+inline const MetricId Chaos = MetricRegistry::intern("Chaos");
+inline const MetricId CpuOnly = MetricRegistry::intern("CpuOnly");
+inline const MetricId Local = MetricRegistry::intern("Local");
+inline const MetricId LocalFallback =
+    MetricRegistry::intern("Local | Fallback");
+inline const MetricId Remote = MetricRegistry::intern("Remote");
+inline const MetricId TxOnly = MetricRegistry::intern("TxOnly");
+
+}  // namespace metric_tags
+
+#endif  // METRICNAMES_H
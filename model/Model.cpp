@@ -1,21 +1,17 @@
 #include "Model.h"
 
 #include <cmath>
-#include <sstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
 
 #include "../core/EnergyManager.h"
-#include "../events/CPUEvent.h"
+#include "../core/Simulator.h"
+#include "../core/Snapshot.h"
 #include "../logger.h"
 #include "../metric.h"
-
-Model::Model() {
-  events[EventType::OnProcessingStart] = [this](Simulator &sim) {
-    this->OnProcessingStart(sim);
-  };
-  events[EventType::OnProcessingComplete] = [this](Simulator &sim) {
-    this->OnProcessingComplete(sim);
-  };
-}
+#include "MetricNames.h"
+#include "TaskStore.h"
 
 void Model::update_energy(Simulator &sim) {
   double now = sim.now();
@@ -31,29 +27,142 @@ void Model::update_energy(Simulator &sim) {
   }
 }
 
-void Model::report_metric(Simulator &sim, const std::string &name, double value,
-                          const std::string &tag, int task_id, const char *file,
+void Model::report_metric(Simulator &sim, MetricId name, double value,
+                          MetricId tag, int64_t task_id, const char *file,
                           int line) {
-  if (name != "BatteryRemaining")
+  if (name != metrics::BatteryRemaining)
     update_energy(sim);
 
   MetricsHub::instance().record(sim.now(), get_id(), name, value, tag, task_id,
-                                file, line);
+                                MetricRegistry::location(file, line));
 }
 
 // Special report function for origin node metrics
-void Model::report_metric_for_node(Simulator &sim, int node_id,
-                                   const std::string &name, double value,
-                                   const std::string &tag, int task_id,
+void Model::report_metric_for_node(Simulator &sim, int node_id, MetricId name,
+                                   double value, MetricId tag, int64_t task_id,
                                    const char *file, int line) {
-  if (node_id == get_id() && name != "BatteryRemaining")
+  if (node_id == get_id() && name != metrics::BatteryRemaining)
     update_energy(sim);
 
   MetricsHub::instance().record(sim.now(), node_id, name, value, tag, task_id,
-                                file, line);
+                                MetricRegistry::location(file, line));
+}
+
+int64_t Model::next_task_id() {
+  if (id < 0 || tasks_created == std::numeric_limits<uint32_t>::max()) {
+    throw std::out_of_range("Model: task ids of entity " +
+                            std::to_string(id) + " exhausted");
+  }
+  return static_cast<int64_t>(static_cast<uint64_t>(id) << 32 |
+                              ++tasks_created);
+}
+
+Model::DrawScope::DrawScope(Model &model) {
+  if (!model.draws_ready) {
+    uint32_t entity = static_cast<uint32_t>(model.id);
+    model.streams = Rng::streams().derive(entity);
+    model.chaos = ChaosManager::instance().start();
+    model.draws_ready = true;
+  }
+  rng = Rng::bind(&model.streams);
+  chaos = ChaosManager::bind(&model.chaos);
+  workload = Workload::bind(&model.workload);
+}
+
+Model::DrawScope::~DrawScope() {
+  Workload::bind(workload);
+  ChaosManager::bind(chaos);
+  Rng::bind(rng);
+}
+
+void Model::set_tag(const std::string &name) {
+  tag = MetricRegistry::intern(name);
+  local_tag = MetricRegistry::intern("Local | " + name);
+  remote_tag = MetricRegistry::intern("Remote | " + name);
+}
+
+std::unique_ptr<ModelState> Model::save_state() const {
+  auto state = std::make_unique<ModelState>();
+  copy_state_to(*state);
+  return state;
+}
+
+void Model::restore_state(const ModelState &state) { copy_state_from(state); }
+
+void Model::copy_state_to(ModelState &state) const {
+  state.processing_queue = processing_queue;
+  state.processing_task = processing_task;
+  state.cpu = cpu;
+  state.battery = battery;
+  state.last_energy_update = last_energy_update;
+  state.streams = streams;
+  state.chaos = chaos.checkpoint();
+  state.draws_ready = draws_ready;
+  state.tasks_created = tasks_created;
+}
+
+void Model::copy_state_from(const ModelState &state) {
+  processing_queue = state.processing_queue;
+  processing_task = state.processing_task;
+  cpu = state.cpu;
+  battery = state.battery;
+  last_energy_update = state.last_energy_update;
+  streams = state.streams;
+  chaos.restore(state.chaos);
+  draws_ready = state.draws_ready;
+  tasks_created = state.tasks_created;
+}
+
+void Model::write_snapshot(SnapshotWriter &out) const {
+  out.pod(id);
+  write_queue(out, processing_queue);
+  out.pod(processing_task);
+  out.pod(cpu.is_busy());
+  out.pod(cpu.get_freq());
+  out.pod(battery);
+  out.pod(last_energy_update);
+  out.pod(streams);
+  out.pod(chaos.checkpoint());
+  out.pods(chaos.history());
+  out.pod(draws_ready);
+  out.pod(tasks_created);
+}
+
+void Model::read_snapshot(SnapshotReader &in) {
+  if (in.pod<int>() != id) {
+    throw std::runtime_error("Snapshot: entity order or ids differ (at id " +
+                             std::to_string(id) + ")");
+  }
+  processing_queue = read_queue(in);
+  processing_task = in.pod<Task::Handle>();
+  if (in.pod<bool>()) {
+    cpu.start();
+  } else {
+    cpu.complete();
+  }
+  cpu.set_freq(in.pod<double>());
+  battery = in.pod<Battery>();
+  last_energy_update = in.pod<double>();
+  streams = in.pod<Rng::Streams>();
+  ChaosManager::Checkpoint c = in.pod<ChaosManager::Checkpoint>();
+  chaos.restore(c, in.pods<double>());
+  draws_ready = in.pod<bool>();
+  tasks_created = in.pod<uint32_t>();
+}
+
+void Model::write_queue(SnapshotWriter &out, std::queue<Task::Handle> queue) {
+  std::vector<Task::Handle> handles;
+  for (; !queue.empty(); queue.pop()) handles.push_back(queue.front());
+  out.pods(handles);
+}
+
+std::queue<Task::Handle> Model::read_queue(SnapshotReader &in) {
+  std::queue<Task::Handle> queue;
+  for (Task::Handle h : in.pods<Task::Handle>()) queue.push(h);
+  return queue;
 }
 
-bool Model::accept_processing_task(Simulator &sim, Task::PtrTask task) {
+bool Model::accept_processing_task(Simulator &sim, Task::Handle task) {
   if (processing_queue.size() < queue_size) {
     processing_queue.push(task);
     if (cpu.is_idle()) {
@@ -61,6 +170,7 @@ bool Model::accept_processing_task(Simulator &sim, Task::PtrTask task) {
     }
     return true;
   }
+  TaskStore::of(sim).release(task);
   return false;
 }
 
@@ -69,70 +179,73 @@ void Model::OnProcessingStart(Simulator &sim) {
     processing_task = processing_queue.front();
     processing_queue.pop();
     // Report processing queue size metric
-    report_metric(sim, "QueueSize_Processing", (double)processing_queue.size());
-    std::stringstream ss;
-    ss << "Task " << processing_task->get_id() << " | Node " << this->get_id()
-       << " | PROCESSING_START"
-       << " | queue_size=" << processing_queue.size();
-    LOG_INFO(sim.now(), ss.str());
+    report_metric(sim, metrics::QueueSizeProcessing,
+                  (double)processing_queue.size());
+    LOG_INFO(sim.now(),
+             "Task {} | Node {} | PROCESSING_START | queue_size={}",
+             TaskStore::of(sim).get(processing_task).get_id(), this->get_id(),
+             processing_queue.size());
     cpu.start();
     schedule_processing_complete(sim);
   }
 }
 
 void Model::OnProcessingComplete(Simulator &sim) {
-  std::stringstream ss;
-  ss << "Task " << processing_task->get_id() << " | Node " << this->get_id()
-     << " | PROCESSING_COMPLETE"
-     << " | completion_time=" << processing_task->spent_time(sim)
-     << " | offloaded=" << (processing_task->get_offloaded() ? "Yes" : "No")
-     << " | success="
-     << (processing_task->spent_time(sim) < processing_task->get_deadline()
-             ? "Yes"
-             : "No");
-  LOG_INFO(sim.now(), ss.str());
+  const Task &task = TaskStore::of(sim).get(processing_task);
+  LOG_INFO(sim.now(),
+           "Task {} | Node {} | PROCESSING_COMPLETE | completion_time={} | "
+           "offloaded={} | success={}",
+           task.get_id(), this->get_id(), task.spent_time(sim),
+           task.get_offloaded() ? "Yes" : "No",
+           task.spent_time(sim) < task.get_deadline() ? "Yes" : "No");
   cpu.complete();
   double energy = EnergyManager::calculate_processing_energy(
-      cpu.get_freq(), processing_task->total_cycles());
-  int origin_id = processing_task->get_origin_node_id();
+      cpu.get_freq(), task.total_cycles(), task.get_drift());
+  int origin_id = task.get_origin_node_id();
   if (origin_id == -1)
     origin_id = this->get_id();
-  bool was_offloaded = processing_task->get_offloaded();
-  int tid = processing_task->get_id();
+  bool was_offloaded = task.get_offloaded();
+  int64_t tid = task.get_id();
 
   if (battery.predict_energy_consumption(energy) < 0.0) {
-    report_metric_for_node(sim, origin_id, "TaskSuccess", 0.0, tag, tid);
-    report_metric(sim, "LowEnergyFail", 1.0, tag, tid);
+    report_metric_for_node(sim, origin_id, metrics::TaskSuccess, 0.0, tag, tid);
+    report_metric(sim, metrics::LowEnergyFail, 1.0, tag, tid);
     report_metric_for_node(
-        sim, origin_id, "OffloadingType", was_offloaded ? 1.0 : 0.0,
-        was_offloaded ? "Remote | " + tag : "Local | " + tag, tid);
+        sim, origin_id, metrics::OffloadingType, was_offloaded ? 1.0 : 0.0,
+        was_offloaded ? remote_tag : local_tag, tid);
+    TaskStore::of(sim).release(processing_task);
+    processing_task = Task::NONE;
     return;
   }
-  double latency = processing_task->spent_time(sim);
+  double latency = task.spent_time(sim);
   // Add transfer time for offloaded tasks (network overhead)
-  double tx_time = processing_task->get_transfer_time();
+  double tx_time = task.get_transfer_time();
   double total_latency = latency + tx_time;
-  report_metric_for_node(sim, origin_id, "TaskLatency", total_latency, "", tid);
-  bool success = (total_latency <= processing_task->get_deadline());
-  report_metric_for_node(sim, origin_id, "TaskSuccess", success ? 1.0 : 0.0,
-                         tag, tid);
-  double margin = processing_task->get_deadline() - total_latency;
-  report_metric_for_node(sim, origin_id, "TaskMargin", margin, tag, tid);
+  report_metric_for_node(sim, origin_id, metrics::TaskLatency, total_latency,
+                         MetricRegistry::EMPTY, tid);
+  bool success = (total_latency <= task.get_deadline());
+  report_metric_for_node(sim, origin_id, metrics::TaskSuccess,
+                         success ? 1.0 : 0.0, tag, tid);
+  double margin = task.get_deadline() - total_latency;
+  report_metric_for_node(sim, origin_id, metrics::TaskMargin, margin, tag, tid);
 
   report_metric_for_node(
-      sim, origin_id, "OffloadingType", was_offloaded ? 1.0 : 0.0,
-      was_offloaded ? "Remote | " + tag : "Local | " + tag, tid);
+      sim, origin_id, metrics::OffloadingType, was_offloaded ? 1.0 : 0.0,
+      was_offloaded ? remote_tag : local_tag, tid);
   battery.consume(energy);
 
-  report_metric(sim, "EnergyConsumption", energy, "CpuOnly", tid);
-  report_metric(sim, "CpuEnergy", energy, tag, tid);
-  report_metric(sim, "BatteryRemaining", battery.get_remaining(), tag, tid);
+  report_metric(sim, metrics::EnergyConsumption, energy, metric_tags::CpuOnly,
+                tid);
+  report_metric(sim, metrics::CpuEnergy, energy, tag, tid);
+  report_metric(sim, metrics::BatteryRemaining, battery.get_remaining(), tag,
+                tid);
 
   if (battery.is_depleted()) {
-    report_metric(sim, "BatteryDepleted", 1.0, tag, tid);
+    report_metric(sim, metrics::BatteryDepleted, 1.0, tag, tid);
   }
 
-  processing_task = nullptr;
+  TaskStore::of(sim).release(processing_task);
+  processing_task = Task::NONE;
   if (!processing_queue.empty()) {
     // Check battery before scheduling next?
     if (!battery.is_depleted()) {
@@ -142,14 +255,13 @@ void Model::OnProcessingComplete(Simulator &sim) {
 }
 
 void Model::schedule_cpu(Simulator &sim) {
-  sim.schedule<CPUEvent>(sim.now(), shared_from_this(),
-                         EventType::OnProcessingStart);
+  sim.schedule(sim.now(), *this, EventType::OnProcessingStart);
 }
 void Model::schedule_processing_complete(Simulator &sim) {
-  sim.schedule<CPUEvent>(sim.now() + cpu.processing_time(processing_task),
-                         shared_from_this(), EventType::OnProcessingComplete);
+  sim.schedule(
+      sim.now() + cpu.processing_time(TaskStore::of(sim).get(processing_task)),
+      *this, EventType::OnProcessingComplete);
 }
 void Model::schedule_cpu_start_event(Simulator &sim) {
-  sim.schedule<CPUEvent>(sim.now() + micro_step, shared_from_this(),
-                         EventType::OnProcessingStart);
+  sim.schedule(sim.now() + micro_step, *this, EventType::OnProcessingStart);
 }
@@ -1,63 +1,138 @@
 #ifndef MODEL_H
 #define MODEL_H
 
-#include <functional>
 #include <memory>
 #include <queue>
 #include <string>
-#include <unordered_map>
 
 #include "Battery.h"
 #include "CPU.h"
-#include "EventType.h"
+#include "../core/ChaosManager.h"
+#include "../core/EventType.h"
 #include "Task.h"
+#include "metric.h"
 #include "utils/IdManager.h"
+#include "utils/Rng.h"
+#include "utils/Workload.h"
 
 class Simulator;  // Forward declaration
+class SnapshotReader;
+class SnapshotWriter;
+
+/**
+ * @brief Mutable state of a Model, saved before each event by the optimistic
+ * parallel engine and restored on rollback
+ */
+struct ModelState {
+  virtual ~ModelState() = default;
+  std::queue<Task::Handle> processing_queue;
+  Task::Handle processing_task = Task::NONE;
+  CPU cpu;
+  Battery battery;
+  double last_energy_update = 0.0;
+  Rng::Streams streams;
+  ChaosManager::Checkpoint chaos;
+  bool draws_ready = false;
+  uint32_t tasks_created = 0;
+};
 
 class Model : public std::enable_shared_from_this<Model> {
  protected:
   int id = IdManager::next_id();
-  std::queue<Task::PtrTask> processing_queue;
-  Task::PtrTask processing_task = nullptr;
+  std::queue<Task::Handle> processing_queue;  // in the simulation's TaskStore
+  Task::Handle processing_task = Task::NONE;
   size_t queue_size = 10;
-  std::string tag = "";
+  // Metric tag (policy name) and its "Local | "/"Remote | " forms
+  MetricId tag = MetricRegistry::EMPTY;
+  MetricId local_tag = MetricRegistry::intern("Local | ");
+  MetricId remote_tag = MetricRegistry::intern("Remote | ");
+  size_t partition = 0;  // owning partition in a ParallelSimulator
+
+  // The entity's own draws, chaos cursor and task ids: a function of the run
+  // seed, the entity id and its own history only, so they are the same
+  // whatever order entities act in and however a parallel run partitions
+  // them. Derived from the bound streams and chaos state at the first draw.
+  Rng::Streams streams;
+  ChaosManager chaos;
+  bool draws_ready = false;
+  Workload workload{Workload::ENTITY_BLOCK};  // blocks of `streams`
+  uint32_t tasks_created = 0;
 
  public:
   using PtrModel = std::shared_ptr<Model>;
-  using Map = std::unordered_map<EventType, std::function<void(Simulator &)>>;
 
   CPU cpu;
   Battery battery;  // Default infinite/zero
-  Map events;
 
   virtual ~Model() = default;
 
-  Model();
+  Model() = default;
 
   int get_id() const { return id; }
+  uint32_t get_tasks_created() const { return tasks_created; }
+  // Position in the run's chaos trajectory of the tasks this entity generates
+  const ChaosManager &get_chaos() const { return chaos; }
+
+  // Ids of generated tasks: the entity id in the high 32 bits, then 1, 2, ...
+  int64_t next_task_id();
+
+  /**
+   * @brief Routes Rng, ChaosManager::instance() and Workload::instance() of
+   * the calling thread to the entity's own while it draws
+   */
+  class DrawScope {
+   public:
+    explicit DrawScope(Model &model);
+    ~DrawScope();
+    DrawScope(const DrawScope &) = delete;
+    DrawScope &operator=(const DrawScope &) = delete;
+
+   private:
+    Rng::Streams *rng;
+    ChaosManager *chaos;
+    Workload *workload;
+  };
+
   size_t get_current_queue_size() const { return processing_queue.size(); }
   size_t get_max_queue_size() const { return queue_size; }
+  size_t get_partition() const { return partition; }
+  void set_partition(size_t index) { partition = index; }
 
   // ... restante da classe
   // Report metric with location tracking
-  void report_metric(Simulator &sim, const std::string &name, double value,
-                     const std::string &tag = "", int task_id = -1,
+  // (names and tags from MetricNames.h or MetricRegistry::intern)
+  void report_metric(Simulator &sim, MetricId name, double value,
+                     MetricId tag = MetricRegistry::EMPTY, int64_t task_id = -1,
                      const char *file = __builtin_FILE(),
                      int line = __builtin_LINE());
-  void report_metric_for_node(Simulator &sim, int node_id,
-                              const std::string &name, double value,
-                              const std::string &tag = "", int task_id = -1,
+  void report_metric_for_node(Simulator &sim, int node_id, MetricId name,
+                              double value,
+                              MetricId tag = MetricRegistry::EMPTY,
+                              int64_t task_id = -1,
                               const char *file = __builtin_FILE(),
                               int line = __builtin_LINE());
 
-  // Accepts task for PROCESSING
-  virtual bool accept_processing_task(Simulator &sim, Task::PtrTask task);
+  // Accepts task for PROCESSING; a rejected task is released
+  virtual bool accept_processing_task(Simulator &sim, Task::Handle task);
 
   void OnProcessingStart(Simulator &sim);
   void OnProcessingComplete(Simulator &sim);
 
+  virtual std::unique_ptr<ModelState> save_state() const;
+  virtual void restore_state(const ModelState &state);
+
+  // Same state in a Snapshot; reading checks the entity id
+  virtual void write_snapshot(SnapshotWriter &out) const;
+  virtual void read_snapshot(SnapshotReader &in);
+
  protected:
+  void set_tag(const std::string &name);
+  void copy_state_to(ModelState &state) const;
+  void copy_state_from(const ModelState &state);
+  static void write_queue(SnapshotWriter &out,
+                          std::queue<Task::Handle> queue);
+  static std::queue<Task::Handle> read_queue(SnapshotReader &in);
+
   virtual void schedule_cpu(Simulator &sim);
   virtual void schedule_processing_complete(Simulator &sim);
   virtual void schedule_cpu_start_event(Simulator &sim);
@@ -23,9 +23,9 @@ class OffPolicy {
 
  public:
   using PtrOffPolicy = std::shared_ptr<OffPolicy>;
-  virtual DecisionResult decide(Task::PtrTask task,
+  virtual DecisionResult decide(const Task &task,
                                 std::vector<RSU::PtrRSU>& rsus);
-  virtual double decision_time(Task::PtrTask task);
+  virtual double decision_time(const Task &task);
   void complete() { current_state = OffPolicyState::Idle; }
   void start() { current_state = OffPolicyState::Busy; }
   bool is_idle() const { return current_state == OffPolicyState::Idle; }
@@ -0,0 +1,63 @@
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FirstRemotePolicy.h"
+#include "IntelligentPolicy.h"
+#include "OffPolicy.h"
+#include "RandomPolicy.h"
+
+// Offloading policies selectable by name on the command line, with the suffix
+// of their result files; the first one is the default for unknown names
+struct PolicyEntry {
+  const char *name;
+  const char *suffix;  // experiment_001_<suffix>_<seed>
+  std::shared_ptr<OffPolicy> (*make)();
+};
+
+inline const PolicyEntry POLICIES[] = {
+    {"Local", "local",
+     []() -> std::shared_ptr<OffPolicy> {
+       return std::make_shared<OffPolicy>();
+     }},
+    {"Random", "random",
+     []() -> std::shared_ptr<OffPolicy> {
+       return std::make_shared<RandomPolicy>();
+     }},
+    {"Intelligent", "intelligent",
+     []() -> std::shared_ptr<OffPolicy> {
+       return std::make_shared<IntelligentPolicy>();
+     }},
+    {"FirstRemote", "first_remote",
+     []() -> std::shared_ptr<OffPolicy> {
+       return std::make_shared<FirstRemotePolicy>();
+     }},
+};
+
+inline const PolicyEntry &find_policy(const std::string &name) {
+  for (const auto &entry : POLICIES) {
+    if (name == entry.name) return entry;
+  }
+  return POLICIES[0];
+}
+
+inline std::vector<std::string> policy_names() {
+  std::vector<std::string> names;
+  for (const auto &entry : POLICIES) names.push_back(entry.name);
+  return names;
+}
+
+inline std::shared_ptr<OffPolicy> create_policy(const std::string &name) {
+  return find_policy(name).make();
+}
+
+// Run label, e.g. experiment_001_first_remote_7
+inline std::string run_name(const std::string &policy, int seed) {
+  return std::string("experiment_001_") + find_policy(policy).suffix + "_" +
+         std::to_string(seed);
+}
+
+#endif  // POLICIES_H
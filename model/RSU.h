@@ -11,7 +11,7 @@ class RSU : public Model {
 
  public:
   using PtrRSU = std::shared_ptr<RSU>;
-  RSU() : Model() { cpu.set_freq(Rng::uniform(4e9, 5e9)); }
+  RSU() : Model() { cpu.set_freq(Rng::uniform(Rng::HARDWARE, 4e9, 5e9)); }
   // RSU receives tasks via accept_processing_task (from Model)
 };
 
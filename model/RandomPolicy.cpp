@@ -3,21 +3,21 @@
 #include "../core/ChaosManager.h"
 #include "Model.h"
 
-DecisionResult RandomPolicy::decide(Task::PtrTask task,
+DecisionResult RandomPolicy::decide(const Task &task,
                                     std::vector<RSU::PtrRSU> &rsus) {
   DecisionType dt = DecisionType::Local;
   RSU::PtrRSU dst = nullptr;
   if (rsus.size() == 0) return {dt, dst};
-  if (Rng::uniform(0.0, 1.0) >= 0.5) {
+  if (Rng::uniform(Rng::POLICY, 0.0, 1.0) >= 0.5) {
     dt = DecisionType::Remote;
-    dst = Rng::sample<RSU::PtrRSU>(rsus);
+    dst = Rng::sample<RSU::PtrRSU>(Rng::POLICY, rsus);
   }
   return {dt, dst};
 }
 
-double RandomPolicy::decision_time(Task::PtrTask task) {
-  double result = Rng::uniform(0.003, 0.005);  // 3–5 ms
-  if (Config::FIELD_TOTAL_CHAOS) {
+double RandomPolicy::decision_time(const Task &task) {
+  double result = Rng::uniform(Rng::DECISION, 0.003, 0.005);  // 3–5 ms
+  if (Config::get().FIELD_TOTAL_CHAOS) {
     double drift = ChaosManager::instance().get_state();
     return Rng::pdrift(result, drift);
   }
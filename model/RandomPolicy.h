@@ -6,9 +6,9 @@
 class RandomPolicy : public OffPolicy {
  public:
   RandomPolicy() : OffPolicy() { name = "RandomPolicy"; }
-  DecisionResult decide(Task::PtrTask task,
+  DecisionResult decide(const Task &task,
                         std::vector<RSU::PtrRSU>& rsus) override;
-  double decision_time(Task::PtrTask task) override;
+  double decision_time(const Task &task) override;
 };
 
 #endif  // RANDOMPOLICY_H
@@ -1,65 +1,89 @@
 #include "Task.h"
 
+#include <limits>
+#include <stdexcept>
+#include <string>
+
 #include "../core/ChaosManager.h"
+#include "../core/Simulator.h"
+
+int32_t Task::narrow(long value, const char *field) {
+  if (value < std::numeric_limits<int32_t>::min() ||
+      value > std::numeric_limits<int32_t>::max()) {
+    throw std::out_of_range(std::string("Task: ") + field + " " +
+                            std::to_string(value) + " exceeds 32 bits");
+  }
+  return static_cast<int32_t>(value);
+}
 
-Task::Task(const Simulator &sim) {
+Task::Task(const Simulator &sim, const Workload::Draws &draws, int64_t id_)
+    : id(id_) {
   timestamp = sim.now();
+  double size, density;
+  const Config::Parameters &config = Config::get();
 
   // --------------------------------------------------
-  // Update Global Chaos State ONCE per task
+  // Update the source's Chaos State ONCE per task
   // This ensures all parameters share the SAME chaos value
   // --------------------------------------------------
-  if (Config::FIELD_TOTAL_CHAOS) {
+  if (config.FIELD_TOTAL_CHAOS) {
     ChaosManager::instance().update();
   }
 
-  // Get the shared chaos state for this task
-  double drift =
-      Config::FIELD_TOTAL_CHAOS ? ChaosManager::instance().get_state() : 0.0;
+  // Get the shared chaos state for this task (kept for its processing)
+  if (config.FIELD_TOTAL_CHAOS) {
+    drift = ChaosManager::instance().get_state();
+  }
 
   // --------------------------------------------------
   // Task Size (Drifted in chaos mode)
   // --------------------------------------------------
-  if (Config::FIELD_TOTAL_CHAOS) {
-    double min_s = Rng::pdrift(Config::TASK_MIN_SIZE, drift);
-    double max_s = Rng::pdrift(Config::TASK_MAX_SIZE, drift);
+  if (config.FIELD_TOTAL_CHAOS) {
+    double min_s = Rng::pdrift(config.TASK_MIN_SIZE, drift);
+    double max_s = Rng::pdrift(config.TASK_MAX_SIZE, drift);
     if (min_s > max_s) {
       std::swap(min_s, max_s);
     }
-    size_bytes = Rng::uniform(min_s, max_s);
+    size = Rng::to_uniform(draws.size, min_s, max_s);
   } else {
-    size_bytes = Rng::uniform(Config::TASK_MIN_SIZE, Config::TASK_MAX_SIZE);
+    size = Rng::to_uniform(draws.size, config.TASK_MIN_SIZE,
+                           config.TASK_MAX_SIZE);
   }
+  size_bytes = narrow(static_cast<long>(size), "size_bytes");
 
   // --------------------------------------------------
   // Density (Drifted in chaos mode)
   // --------------------------------------------------
-  if (Config::FIELD_TOTAL_CHAOS) {
-    double mean = Rng::pdrift(Config::TASK_MEAN_DENSITY, drift);
-    double std = Rng::pdrift(Config::TASK_STD_DENSITY, drift);
-    density_cycles_bytes = Rng::normal(mean, std);
+  if (config.FIELD_TOTAL_CHAOS) {
+    double mean = Rng::pdrift(config.TASK_MEAN_DENSITY, drift);
+    double std = Rng::pdrift(config.TASK_STD_DENSITY, drift);
+    density = mean + std * draws.density;
   } else {
-    density_cycles_bytes =
-        Rng::normal(Config::TASK_MEAN_DENSITY, Config::TASK_STD_DENSITY);
+    density =
+        config.TASK_MEAN_DENSITY + config.TASK_STD_DENSITY * draws.density;
   }
+  density_cycles_bytes =
+      narrow(static_cast<long>(density), "density_cycles_bytes");
 
   // --------------------------------------------------
   // Deadline (Drifted in chaos mode)
   // --------------------------------------------------
-  if (Config::FIELD_TOTAL_CHAOS) {
-    double min_d = Rng::pdrift(Config::TASK_MIN_DEADLINE, drift);
-    double max_d = Rng::pdrift(Config::TASK_MAX_DEADLINE, drift);
+  if (config.FIELD_TOTAL_CHAOS) {
+    double min_d = Rng::pdrift(config.TASK_MIN_DEADLINE, drift);
+    double max_d = Rng::pdrift(config.TASK_MAX_DEADLINE, drift);
     if (min_d > max_d) {
       std::swap(min_d, max_d);
     }
-    deadline = Rng::uniform(min_d, max_d);
+    deadline = Rng::to_uniform(draws.deadline, min_d, max_d);
   } else {
-    deadline =
-        Rng::uniform(Config::TASK_MIN_DEADLINE, Config::TASK_MAX_DEADLINE);
+    deadline = Rng::to_uniform(draws.deadline, config.TASK_MIN_DEADLINE,
+                               config.TASK_MAX_DEADLINE);
   }
 }
 
-double Task::spent_time(Simulator &sim) { return sim.now() - timestamp; }
+double Task::spent_time(const Simulator &sim) const {
+  return sim.now() - timestamp;
+}
 
 std::ostream &operator<<(std::ostream &out, const Task &t) {
   out << "Task { "
@@ -1,43 +1,56 @@
 #ifndef TASK_H
 #define TASK_H
 
+#include <cstdint>
 #include <iostream>
-#include <memory>
 
-#include "core/Config.h"     // Added Config
-#include "core/Simulator.h"  // Needed for constructor argument and method
+#include "core/Config.h"  // Added Config
 #include "utils/IdManager.h"
 #include "utils/Rng.h"
+#include "utils/Workload.h"
 
+class Simulator;
+
+// Packed record (56 bytes), held by value in a TaskStore; sizes and
+// densities are checked to fit their 32-bit fields
 class Task {
   double timestamp = 0;
-  int id = IdManager::next_id();
-  int origin_node_id = -1;  // Added origin node ID
-
-  long size_bytes;
-  long density_cycles_bytes;
   double deadline;
-  bool offloaded = false;
   double transfer_time =
       0.0;  // Time spent transferring data (for offloaded tasks)
+  int64_t id = IdManager::next_id();
+  int32_t origin_node_id = -1;  // Added origin node ID
+  int32_t size_bytes;
+  int32_t density_cycles_bytes;
+  bool offloaded = false;
+  double drift = 0.0;  // chaos state at creation, 0 outside chaos mode
   friend std::ostream &operator<<(std::ostream &out, const Task &t);
 
+  static int32_t narrow(long value, const char *field);
+
  public:
-  using PtrTask = std::shared_ptr<Task>;
+  // Index of a task in its simulation's TaskStore
+  using Handle = uint32_t;
+  static constexpr Handle NONE = UINT32_MAX;
 
-  Task(const Simulator &sim);
+  // Generated at sim.now() from pre-drawn variates
+  Task(const Simulator &sim, const Workload::Draws &draws,
+       int64_t id_ = IdManager::next_id());
   Task(double timestamp_, long size_bytes_, long density_cycles_bytes_,
        double deadline_)
       : timestamp(timestamp_),
-        size_bytes(size_bytes_),
-        density_cycles_bytes(density_cycles_bytes_),
-        deadline(deadline_) {};
-  long total_cycles() const { return size_bytes * density_cycles_bytes; }
-  int get_id() const { return id; }
+        deadline(deadline_),
+        size_bytes(narrow(size_bytes_, "size_bytes")),
+        density_cycles_bytes(
+            narrow(density_cycles_bytes_, "density_cycles_bytes")) {};
+  long total_cycles() const {
+    return static_cast<long>(size_bytes) * density_cycles_bytes;
+  }
+  int64_t get_id() const { return id; }
   void set_origin_node_id(int id) { origin_node_id = id; }
   int get_origin_node_id() const { return origin_node_id; }
   double get_deadline() const { return deadline; }
-  double spent_time(Simulator &sim);
+  double spent_time(const Simulator &sim) const;
   bool get_offloaded() const { return offloaded; }
   void set_offloaded(bool val) { offloaded = val; }
   long get_data_size() const { return size_bytes; }
@@ -45,6 +58,9 @@ class Task {
   double get_timestamp() const { return timestamp; }
   double get_transfer_time() const { return transfer_time; }
   void set_transfer_time(double t) { transfer_time = t; }
+  // Chaos drift shared by every parameter of the task (sizes, deadline,
+  // processing time and energy)
+  double get_drift() const { return drift; }
 };
 
 std::ostream &operator<<(std::ostream &out, const Task &t);
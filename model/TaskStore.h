@@ -0,0 +1,134 @@
+#ifndef TASKSTORE_H
+#define TASKSTORE_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "../core/RunState.h"
+#include "../core/Simulator.h"
+#include "../core/Snapshot.h"
+#include "Task.h"
+
+/**
+ * @brief Tasks of one simulation, addressed by dense 32-bit handles
+ *
+ * Queues and events pass Task::Handle around instead of shared_ptr<Task>:
+ * no reference counting, 4 bytes per queue entry, and the records sit in
+ * one contiguous vector whose slots are reused once a task is released.
+ * References from get() / modify() are invalidated by add().
+ *
+ * With undo enabled (optimistic parallel partitions) every change is
+ * logged, so undo(mark) returns the store exactly to an earlier mark();
+ * forget(mark) drops the entries no rollback can reach any more.
+ *
+ * It is the run state of a Simulator, installed by the first of().
+ */
+class TaskStore final : public RunState {
+ public:
+  using Handle = Task::Handle;
+
+  // Tasks of `sim` (or of one partition)
+  static TaskStore &of(Simulator &sim) {
+    if (!sim.run_state()) sim.set_run_state(std::make_unique<TaskStore>());
+    return static_cast<TaskStore &>(*sim.run_state());
+  }
+
+  Handle add(const Task &task) {
+    Handle h;
+    if (free.empty()) {
+      h = static_cast<Handle>(tasks.size());
+      if (h == Task::NONE) throw std::length_error("TaskStore: full");
+      tasks.push_back(task);
+      if (undo_enabled) log.push_back({Op::Append, h, task});
+    } else {
+      h = free.back();
+      free.pop_back();
+      if (undo_enabled) log.push_back({Op::Reuse, h, tasks[h]});
+      tasks[h] = task;
+    }
+    return h;
+  }
+
+  const Task &get(Handle h) const { return tasks[h]; }
+
+  // Mutable access; logs the previous record when undo is enabled
+  Task &modify(Handle h) {
+    if (undo_enabled) log.push_back({Op::Modify, h, tasks[h]});
+    return tasks[h];
+  }
+
+  // The handle may be returned by a later add()
+  void release(Handle h) {
+    free.push_back(h);
+    if (undo_enabled) log.push_back({Op::Release, h, tasks[h]});
+  }
+
+  size_t live() const { return tasks.size() - free.size(); }
+  size_t capacity() const { return tasks.size(); }
+
+  void set_undo(bool enable) override { undo_enabled = enable; }
+  uint64_t mark() const override { return log_base + log.size(); }
+
+  // Reverts every change logged since `m`, latest first
+  void undo(uint64_t m) override {
+    while (mark() > m) {
+      const Entry &e = log.back();
+      switch (e.op) {
+        case Op::Append:
+          tasks.pop_back();
+          break;
+        case Op::Reuse:
+          tasks[e.handle] = e.before;
+          free.push_back(e.handle);
+          break;
+        case Op::Modify:
+          tasks[e.handle] = e.before;
+          break;
+        case Op::Release:
+          free.pop_back();
+          break;
+      }
+      log.pop_back();
+    }
+  }
+
+  // Records and free slots; the undo log is not part of a snapshot
+  void write_snapshot(SnapshotWriter &out) const override {
+    out.pods(tasks);
+    out.pods(free);
+  }
+  void read_snapshot(SnapshotReader &in) override {
+    tasks = in.pods<Task>();
+    free = in.pods<Handle>();
+    log.clear();
+    log_base = 0;
+  }
+
+  // Drops log entries before `m`
+  void forget(uint64_t m) override {
+    while (log_base < m && !log.empty()) {
+      log.pop_front();
+      ++log_base;
+    }
+  }
+
+ private:
+  enum class Op : uint8_t { Append, Reuse, Modify, Release };
+
+  struct Entry {
+    Op op;
+    Handle handle;
+    Task before;  // record replaced by Reuse / Modify
+  };
+
+  std::vector<Task> tasks;
+  std::vector<Handle> free;  // released slots, reused last in first out
+  bool undo_enabled = false;
+  std::deque<Entry> log;
+  uint64_t log_base = 0;  // mark of log.front()
+};
+
+#endif  // TASKSTORE_H
@@ -1,21 +1,19 @@
 #include "Vehicle.h"
 
-#include <sstream>
+#include <cmath>
+#include <stdexcept>
 
-#include "../events/DecisionEvent.h"
+#include "../core/Snapshot.h"
+#include "../events/OffloadArrivalEvent.h"
 #include "../logger.h"
+#include "MetricNames.h"
+#include "TaskStore.h"
 #include "core/EnergyManager.h"
 #include "core/TransferManager.h"
 
 Vehicle::Vehicle(OffPolicy::PtrOffPolicy policy) : Model() {
-  tag = policy->get_name();
+  set_tag(policy->get_name());
   off_policy = policy;
-  events[EventType::OnDecisionStart] = [this](Simulator &sim) {
-    this->onDecisionStart(sim);
-  };
-  events[EventType::OnDecisionComplete] = [this](Simulator &sim) {
-    this->onDecisionComplete(sim);
-  };
 }
 
 void Vehicle::set_rsus(const std::vector<RSU::PtrRSU> &rsus_) {
@@ -26,7 +24,46 @@ void Vehicle::set_rsus(const std::vector<RSU::PtrRSU> &rsus_) {
   }
 }
 
-void Vehicle::add_task_to_decision(Simulator &sim, Task::PtrTask task) {
+std::unique_ptr<ModelState> Vehicle::save_state() const {
+  auto state = std::make_unique<VehicleState>();
+  copy_state_to(*state);
+  state->decision_queue = decision_queue;
+  state->decision_task = decision_task;
+  state->policy_busy = off_policy->is_busy();
+  return state;
+}
+
+void Vehicle::restore_state(const ModelState &state) {
+  const auto &s = static_cast<const VehicleState &>(state);
+  copy_state_from(s);
+  decision_queue = s.decision_queue;
+  decision_task = s.decision_task;
+  if (s.policy_busy) {
+    off_policy->start();
+  } else {
+    off_policy->complete();
+  }
+}
+
+void Vehicle::write_snapshot(SnapshotWriter &out) const {
+  Model::write_snapshot(out);
+  write_queue(out, decision_queue);
+  out.pod(decision_task);
+  out.pod(off_policy->is_busy());
+}
+
+void Vehicle::read_snapshot(SnapshotReader &in) {
+  Model::read_snapshot(in);
+  decision_queue = read_queue(in);
+  decision_task = in.pod<Task::Handle>();
+  if (in.pod<bool>()) {
+    off_policy->start();
+  } else {
+    off_policy->complete();
+  }
+}
+
+void Vehicle::add_task_to_decision(Simulator &sim, Task::Handle task) {
   decision_queue.push(task);
   if (off_policy->is_idle()) {
     schedule_decision_start_event(sim);
@@ -35,105 +72,133 @@ void Vehicle::add_task_to_decision(Simulator &sim, Task::PtrTask task) {
 
 void Vehicle::onDecisionStart(Simulator &sim) {
   if (off_policy->is_idle() && !decision_queue.empty()) {
-    report_metric(sim, "QueueSize_Decision", (double)decision_queue.size());
+    report_metric(sim, metrics::QueueSizeDecision,
+                  (double)decision_queue.size());
     decision_task = decision_queue.front();
     decision_queue.pop();
     off_policy->start();
-    std::stringstream ss;
-    ss << "Task " << decision_task->get_id() << " | Node " << this->get_id()
-       << " | DECISION_START"
-       << " | queue_size=" << decision_queue.size();
-    LOG_INFO(sim.now(), ss.str());
+    LOG_INFO(sim.now(), "Task {} | Node {} | DECISION_START | queue_size={}",
+             TaskStore::of(sim).get(decision_task).get_id(), this->get_id(),
+             decision_queue.size());
 
     schedule_decision(sim);
   }
 }
 
 void Vehicle::onDecisionComplete(Simulator &sim) {
-  std::stringstream ss;
-  int tid = decision_task->get_id();
-  ss << "Task " << tid << " | Node " << this->get_id()
-     << " | DECISION_COMPLETE";
-  auto result = off_policy->decide(decision_task, rsus);
-  ss << " | decision="
-     << (result.decision_type == DecisionType::Local ? "Local" : "Remote")
-     << " | destiny=Node "
-     << (result.choosed_device != nullptr ? result.choosed_device->get_id()
-                                          : get_id());
-  LOG_INFO(sim.now(), ss.str());
+  int64_t tid = TaskStore::of(sim).get(decision_task).get_id();
+  DecisionResult result;
+  {
+    DrawScope scope(*this);
+    result = off_policy->decide(TaskStore::of(sim).get(decision_task), rsus);
+  }
+  LOG_INFO(sim.now(),
+           "Task {} | Node {} | DECISION_COMPLETE | decision={} | "
+           "destiny=Node {}",
+           tid, this->get_id(),
+           result.decision_type == DecisionType::Local ? "Local" : "Remote",
+           result.choosed_device != nullptr ? result.choosed_device->get_id()
+                                            : get_id());
   off_policy->complete();
 
   if (result.decision_type == DecisionType::Local) {
-    // Local processing: call Base implementation
-    report_metric(sim, "TransferTime", 0.0, "Local", tid);  // No transfer time
+    // Local processing: call Base implementation (no transfer time)
+    report_metric(sim, metrics::TransferTime, 0.0, metric_tags::Local, tid);
     bool accepted = this->accept_processing_task(sim, decision_task);
     if (!accepted)
-      report_metric_for_node(sim, get_id(), "FullQueueError", 1.0, "Local",
-                             tid);
+      report_metric_for_node(sim, get_id(), metrics::FullQueueError, 1.0,
+                             metric_tags::Local, tid);
   } else {
     // Remote processing
-    decision_task->set_offloaded(true);
+    TaskStore::of(sim).modify(decision_task).set_offloaded(true);
     if (result.choosed_device) {
-      bool accepted =
-          result.choosed_device->accept_processing_task(sim, decision_task);
-      if (!accepted) {
-        report_metric_for_node(sim, result.choosed_device->get_id(),
-                               "FullQueueError", 1.0, "Remote", tid);
+      if (Config::get().UPLINK_LATENCY > 0.0) {
+        // The task reaches the RSU after the uplink latency and is admitted
+        // there, possibly by another partition of a parallel run: the record
+        // travels by value and is stored again on arrival
+        transmit(sim, TaskStore::of(sim).modify(decision_task));
+        Model::PtrModel device = result.choosed_device;
+        Task task = TaskStore::of(sim).get(decision_task);
+        TaskStore::of(sim).release(decision_task);
+        double arrival = sim.now() + Config::get().UPLINK_LATENCY;
+        // The task id orders arrivals that share a time, identically in
+        // sequential and partitioned runs
+        sim.post(device->get_partition(), arrival,
+                 static_cast<uint64_t>(task.get_id()),
+                 [device, task](Simulator &dst, double t) {
+                   return dst.schedule<OffloadArrivalEvent>(t, device, task);
+                 });
       } else {
-        double tx_energy = EnergyManager::calculate_transmission_energy(
-            decision_task->get_data_size(), 100.0);  // 100m dist
-
-        double bandwidth = TransferManager::DEFAULT_BANDWIDTH;
-
-        // In CHAOS MODE, bandwidth fluctuates!
-        if (Config::FIELD_TOTAL_CHAOS) {
-          // Random fluctuation between 50% and 100% of bandwidth
-          // We use the task ID as seed addition to keep it deterministic per
-          // run but random per task
-          int chaos_seed = (int)decision_task->get_timestamp() * 1000 + tid;
-          std::srand(chaos_seed);
-          double factor = 0.5 + (std::rand() % 50) / 100.0;  // 0.5 to 1.0
-          bandwidth *= factor;
-          report_metric(sim, "BandwidthDrop", factor, "Chaos", tid);
+        if (result.choosed_device->get_partition() != partition) {
+          throw std::logic_error(
+              "Vehicle: offloading to another partition needs "
+              "UPLINK_LATENCY > 0");
+        }
+        bool accepted =
+            result.choosed_device->accept_processing_task(sim, decision_task);
+        if (!accepted) {
+          report_metric_for_node(sim, result.choosed_device->get_id(),
+                                 metrics::FullQueueError, 1.0,
+                                 metric_tags::Remote, tid);
+        } else {
+          transmit(sim, TaskStore::of(sim).modify(decision_task));
         }
-
-        // Transfer Time is NOW REAL - affects deadline!
-        double tx_time = TransferManager::calculate_transfer_time(
-            decision_task->get_data_size(), bandwidth);
-
-        // Store transfer time in task so Model can add it to latency
-        decision_task->set_transfer_time(tx_time);
-        report_metric(sim, "TransferTime", tx_time, "TxOnly", tid);
-
-        this->battery.consume(tx_energy);
-        report_metric(sim, "EnergyConsumption", tx_energy, "TxOnly", tid);
-        report_metric(sim, "TxEnergy", tx_energy, tag, tid);
       }
     } else {
       // Fallback if no device chosen? For now Local.
-      report_metric(sim, "TransferTime", 0.0, "Local", tid);
+      report_metric(sim, metrics::TransferTime, 0.0, metric_tags::Local, tid);
       bool accepted = this->accept_processing_task(sim, decision_task);
       if (!accepted)
-        report_metric_for_node(sim, get_id(), "FullQueueError", 1.0,
-                               "Local | Fallback", tid);
+        report_metric_for_node(sim, get_id(), metrics::FullQueueError, 1.0,
+                               metric_tags::LocalFallback, tid);
     }
   }
 
-  decision_task = nullptr;
+  decision_task = Task::NONE;
   if (!decision_queue.empty()) {
     schedule_decision_start_event(sim);
   }
 }
 
+void Vehicle::transmit(Simulator &sim, Task &task) {
+  int64_t tid = task.get_id();
+  double tx_energy = EnergyManager::calculate_transmission_energy(
+      task.get_data_size(), 100.0, task.get_drift());  // 100m dist
+
+  double bandwidth = TransferManager::DEFAULT_BANDWIDTH;
+
+  // In CHAOS MODE, bandwidth fluctuates!
+  if (Config::get().FIELD_TOTAL_CHAOS) {
+    // Random fluctuation between 50% and 100% of bandwidth, drawn at the
+    // task id of the context's stream: deterministic per run but random per
+    // task, whichever partition or replica transmits it
+    double u = Rng::unit_at(Rng::NETWORK, static_cast<uint64_t>(tid));
+    double factor = 0.5 + std::floor(50.0 * u) / 100.0;  // 0.5 to 0.99
+    bandwidth *= factor;
+    report_metric(sim, metrics::BandwidthDrop, factor, metric_tags::Chaos, tid);
+  }
+
+  // Transfer Time is NOW REAL - affects deadline!
+  double tx_time = TransferManager::calculate_transfer_time(
+      task.get_data_size(), bandwidth);
+
+  // Store transfer time in task so Model can add it to latency
+  task.set_transfer_time(tx_time);
+  report_metric(sim, metrics::TransferTime, tx_time, metric_tags::TxOnly, tid);
+
+  this->battery.consume(tx_energy);
+  report_metric(sim, metrics::EnergyConsumption, tx_energy,
+                metric_tags::TxOnly, tid);
+  report_metric(sim, metrics::TxEnergy, tx_energy, tag, tid);
+}
+
 void Vehicle::schedule_decision(Simulator &sim) {
-  sim.schedule<DecisionEvent>(
-      sim.now() + off_policy->decision_time(decision_task),
-      std::static_pointer_cast<Vehicle>(shared_from_this()),
-      EventType::OnDecisionComplete);
+  DrawScope scope(*this);
+  sim.schedule(
+      sim.now() + off_policy->decision_time(TaskStore::of(sim).get(decision_task)),
+      *this, EventType::OnDecisionComplete);
 }
 
 void Vehicle::schedule_decision_start_event(Simulator &sim) {
-  sim.schedule<DecisionEvent>(
-      sim.now(), std::static_pointer_cast<Vehicle>(shared_from_this()),
-      EventType::OnDecisionStart);
+  sim.schedule(sim.now(), *this, EventType::OnDecisionStart);
 }
@@ -9,24 +9,38 @@
 #include "OffPolicy.h"
 #include "model/RSU.h"
 
+// Model state plus the decision stage; the TaskStore undoes changes to the
+// task records themselves
+struct VehicleState : ModelState {
+  std::queue<Task::Handle> decision_queue;
+  Task::Handle decision_task = Task::NONE;
+  bool policy_busy = false;
+};
+
 class Vehicle : public Model {
   arma::vec pos = {};
   arma::vec vel = {};
   std::vector<RSU::PtrRSU> rsus;
-  std::queue<Task::PtrTask> decision_queue;
-  Task::PtrTask decision_task = nullptr;
+  std::queue<Task::Handle> decision_queue;
+  Task::Handle decision_task = Task::NONE;
   OffPolicy::PtrOffPolicy off_policy = nullptr;
 
  public:
   using PtrVehicle = std::shared_ptr<Vehicle>;
   Vehicle(OffPolicy::PtrOffPolicy policy);
-  void add_task_to_decision(Simulator &sim, Task::PtrTask task);
+  void add_task_to_decision(Simulator &sim, Task::Handle task);
   void onDecisionStart(Simulator &sim);
   void onDecisionComplete(Simulator &sim);
   void set_rsus(const std::vector<RSU::PtrRSU> &rsus_);
   const std::vector<RSU::PtrRSU> get_rsus() const { return rsus; }
 
+  std::unique_ptr<ModelState> save_state() const override;
+  void restore_state(const ModelState &state) override;
+  void write_snapshot(SnapshotWriter &out) const override;
+  void read_snapshot(SnapshotReader &in) override;
+
  protected:
+  void transmit(Simulator &sim, Task &task);
   void schedule_decision(Simulator &sim);
   void schedule_decision_start_event(Simulator &sim);
 };
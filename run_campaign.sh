@@ -9,40 +9,46 @@ BASE_SEED=1978
 # Create results directory if it doesn't exist
 mkdir -p results
 
-# Compile Simulator to ensure everything is up to date
-echo "Compiling Simulator..."
-make -j4
+# Compile the campaign runner (one process, all replicas)
+echo "Compiling campaign..."
+g++ -std=gnu++1z -O2 -pthread -I. -o campaign \
+    campaign.cpp \
+    core/Simulator.cpp \
+    core/EventQueue.cpp \
+    core/EventType.cpp \
+    core/CalendarQueue.cpp \
+    core/RadixQueue.cpp \
+    core/TimingWheel.cpp \
+    core/Snapshot.cpp \
+    core/EngineStats.cpp \
+    core/Tracer.cpp \
+    core/ParallelSimulator.cpp \
+    core/SimContext.cpp \
+    core/Config.cpp \
+    events/SpecifiedTasksEvent.cpp \
+    events/TaskGenerationEvent.cpp \
+    model/CPU.cpp \
+    model/EventHandlers.cpp \
+    model/Model.cpp \
+    model/OffPolicy.cpp \
+    model/RandomPolicy.cpp \
+    model/FirstRemotePolicy.cpp \
+    model/IntelligentPolicy.cpp \
+    model/Task.cpp \
+    model/Vehicle.cpp
 
 echo "Starting Simulation Campaign..."
 echo "Policies: ${POLICIES[*]}"
 echo "Repeats: $REPEATS"
 echo "Duration: $DURATION s"
 
-# Iterate over each policy
-for policy in "${POLICIES[@]}"; do
-    echo "------------------------------------------------"
-    echo "Running policy: $policy"
-    echo "------------------------------------------------"
-    
-    # Run repeats
-    for i in $(seq 1 $REPEATS); do
-        # Generate a unique seed for this run
-        SEED=$((BASE_SEED + i))
-        
-        # Run simulation in background to speed up (optional)
-        # Remove '&' and 'wait' logic if you prefer sequential execution
-        ./tank_simulator "$policy" "$DURATION" "$SEED" --chaos > /dev/null &
-        
-        # Limit parallel jobs to avoid overloading (e.g., max 8 parallel)
-        if (( i % 4 == 0 )); then
-            wait
-        fi
-    done
-    
-    # Wait for remaining jobs of this policy
-    wait
-    echo "Finished $policy."
-done
+# Replicas run on a work-stealing pool sized to the machine and are
+# aggregated in process into results/aggregated_*.csv. Finished replicas
+# are journaled: rerunning this script resumes an interrupted campaign
+# (pass --fresh to start over).
+POLICY_LIST=$(IFS=,; echo "${POLICIES[*]}")
+./campaign --policies="$POLICY_LIST" --repeats="$REPEATS" \
+    --duration="$DURATION" --base-seed="$BASE_SEED" --chaos "$@"
 
 echo "------------------------------------------------"
 echo "Campaign Completed!"
@@ -52,18 +58,7 @@ echo "Campaign Completed!"
 echo "------------------------------------------------"
 echo "Starting Post-Processing Pipeline..."
 
-# 1. Compile Aggregator (Fast C++ Tool)
-if [ ! -f "tools/log_aggregator" ] || [ "tools/LogAggregator.cpp" -nt "tools/log_aggregator" ]; then
-    echo "Compiling C++ Log Aggregator..."
-    mkdir -p tools
-    g++ -O3 -std=c++17 -pthread -o tools/log_aggregator tools/LogAggregator.cpp
-fi
-
-# 2. Run Aggregation
-echo "Aggregating Logs (C++)..."
-./tools/log_aggregator results/
-
-# 3. Generate Dashboard (Python)
+# Generate Dashboard (Python)
 echo "Generating Dashboard..."
 PYTHON_EXEC="/home/sergiosvieira/miniconda3/envs/simulator/bin/python"
 
@@ -3,7 +3,8 @@
  * @brief Execute manual/deterministic scenarios
  *
  * Usage:
- *   ./run_scenario <scenario_name> [--chaos] [seed]
+ *   ./run_scenario <scenario_name> [--chaos] [--stats] [--trace=FILE]
+ *                  [--binary-metrics] [seed]
  *
  * Available scenarios:
  *   - Oracle         : Optimal decisions for chaos
@@ -19,6 +20,7 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -26,10 +28,13 @@
 #include "core/ChaosManager.h"
 #include "core/Config.h"
 #include "core/Simulator.h"
+#include "core/Tracer.h"
 #include "events/SpecifiedTasksEvent.h"
 #include "logger.h"
 #include "metric.h"
+#include "metric_columns.h"
 #include "model/DeterministicPolicy.h"
+#include "model/MetricNames.h"
 #include "model/RSU.h"
 #include "model/Vehicle.h"
 #include "scenarios/OracleScenario.h"
@@ -38,7 +43,9 @@
 using std::cout, std::endl;
 
 void print_usage() {
-  cout << "Usage: ./run_scenario <scenario_name> [--chaos] [seed]" << endl;
+  cout << "Usage: ./run_scenario <scenario_name> [--chaos] [--stats] "
+          "[--trace=FILE] [--binary-metrics] [seed]"
+       << endl;
   cout << endl;
   cout << "Available scenarios:" << endl;
   cout << "  Oracle       - Optimal decisions for chaotic environment" << endl;
@@ -47,6 +54,10 @@ void print_usage() {
   cout << endl;
   cout << "Options:" << endl;
   cout << "  --chaos      - Enable chaos mode (non-stationary)" << endl;
+  cout << "  --stats      - Print engine statistics after the run" << endl;
+  cout << "  --trace=FILE - Write a Chrome trace of the run to FILE" << endl;
+  cout << "  --binary-metrics - Write metrics as .mcol columns, not CSV"
+       << endl;
   cout << "  seed         - Random seed (default: 1978)" << endl;
 }
 
@@ -71,6 +82,9 @@ int main(int argc, char **argv) {
 
   std::string scenario_name = argv[1];
   int seed = 1978;
+  bool show_stats = false;
+  std::string trace_file;
+  bool binary_metrics = false;
 
   // Parse arguments
   for (int i = 2; i < argc; ++i) {
@@ -78,6 +92,13 @@ int main(int argc, char **argv) {
     if (arg == "--chaos") {
       Config::set_chaos_mode();
       cout << "!!! CHAOS MODE ACTIVATED !!!" << endl;
+    } else if (arg == "--stats") {
+      show_stats = true;
+    } else if (arg == "--binary-metrics") {
+      binary_metrics = true;
+    } else if (arg.rfind("--trace=", 0) == 0) {
+      trace_file = arg.substr(8);
+      Tracer::enable();
     } else if (arg[0] != '-') {
       seed = std::stoi(arg);
     }
@@ -100,7 +121,7 @@ int main(int argc, char **argv) {
   cout << "========================================" << endl;
 
   // Set seeds
-  Rng::engine().seed(seed);
+  Rng::streams().seed(seed);
   ChaosManager::instance().seed(seed);
 
   // Create simulator
@@ -114,38 +135,45 @@ int main(int argc, char **argv) {
 
   // Setup metrics
   std::string result_file = "results/scenario_" + scenario->name() + "_" +
-                            std::to_string(seed) + ".csv";
+                            std::to_string(seed) +
+                            (binary_metrics ? ".mcol" : ".csv");
+  Logger::instance().open(
+      "logs/" + std::filesystem::path(result_file).stem().string() + ".log");
   MetricsHub::instance().clearListeners();
-  auto csvCollector = std::make_shared<CSVMetricsCollector>(result_file);
-  MetricsHub::instance().addListener(csvCollector);
+  std::shared_ptr<IMetricListener> collector;
+  if (binary_metrics) {
+    collector = std::make_shared<ColumnarMetricsCollector>(result_file);
+  } else {
+    collector = std::make_shared<CSVMetricsCollector>(result_file);
+  }
+  MetricsHub::instance().addListener(collector);
 
   // Create RSUs
   std::vector<RSU::PtrRSU> rsus = {std::make_shared<RSU>()};
   for (auto r : rsus) {
     r->battery = Battery(10000.0);
-    r->report_metric(sim, "BatteryRemaining", r->battery.get_remaining());
+    r->report_metric(sim, metrics::BatteryRemaining,
+                     r->battery.get_remaining());
   }
 
   // Create vehicle with deterministic policy
   auto vehicle = std::make_shared<Vehicle>(policy);
   vehicle->set_rsus(rsus);
   vehicle->battery = Battery(10000.0);
-  vehicle->report_metric(sim, "BatteryRemaining",
+  vehicle->report_metric(sim, metrics::BatteryRemaining,
                          vehicle->battery.get_remaining());
 
-  // Set tasks for SpecifiedTasksEvent
-  SpecifiedTasksEvent::reset();
-  SpecifiedTasksEvent::tasks = tasks;
-
-  // Schedule first task
+  // Schedule first task; each event schedules the next one
   if (!tasks.empty()) {
-    sim.schedule<SpecifiedTasksEvent>(tasks[0]->get_timestamp(), vehicle);
+    auto list = std::make_shared<const std::vector<Task>>(tasks);
+    sim.schedule<SpecifiedTasksEvent>(tasks[0].get_timestamp(), vehicle,
+                                      list);
   }
 
   // Calculate duration based on last task
   double duration = 20.0;  // Default
   if (!tasks.empty()) {
-    duration = tasks.back()->get_timestamp() + 10.0;
+    duration = tasks.back().get_timestamp() + 10.0;
   }
 
   cout << "Simulation duration: " << duration << "s" << endl;
@@ -156,8 +184,8 @@ int main(int argc, char **argv) {
   sim.run(duration);
 
   // Chaos validation
-  if (Config::FIELD_TOTAL_CHAOS) {
-    const auto &z = ChaosManager::instance().history();
+  if (Config::get().FIELD_TOTAL_CHAOS) {
+    const auto &z = vehicle->get_chaos().history();
     if (z.size() > 2) {
       double num = 0.0, den = 0.0;
       for (size_t t = 1; t < z.size(); ++t) {
@@ -174,6 +202,15 @@ int main(int argc, char **argv) {
     }
   }
 
+  if (show_stats) sim.engine_stats().print(cout);
+  if (!trace_file.empty()) {
+    if (!Tracer::write(trace_file)) {
+      cout << "Cannot write trace " << trace_file << endl;
+      return 1;
+    }
+    cout << "Trace written to " << trace_file << endl;
+  }
+
   cout << "========================================" << endl;
   cout << "Scenario complete: " << scenario->name() << endl;
   cout << "========================================" << endl;
@@ -15,10 +15,21 @@ echo "=========================================="
 g++ -std=gnu++1z -O2 -I. -o run_scenario \
     run_scenario.cpp \
     core/Simulator.cpp \
+    core/EventQueue.cpp \
+    core/EventType.cpp \
+    core/CalendarQueue.cpp \
+    core/RadixQueue.cpp \
+    core/TimingWheel.cpp \
+    core/Snapshot.cpp \
+    core/EngineStats.cpp \
+    core/Tracer.cpp \
+    core/ParallelSimulator.cpp \
+    core/SimContext.cpp \
     core/Config.cpp \
     events/SpecifiedTasksEvent.cpp \
     events/TaskGenerationEvent.cpp \
     model/CPU.cpp \
+    model/EventHandlers.cpp \
     model/Model.cpp \
     model/OffPolicy.cpp \
     model/RandomPolicy.cpp \
@@ -65,17 +65,16 @@ class Scenario {
    * @param sim Simulator reference (for Task constructor)
    * @return Pair of (tasks, policy with decisions set)
    */
-  std::pair<std::vector<Task::PtrTask>, std::shared_ptr<DeterministicPolicy>>
+  std::pair<std::vector<Task>, std::shared_ptr<DeterministicPolicy>>
   create(Simulator &sim) const {
     auto scenario_tasks = build_tasks();
-    std::vector<Task::PtrTask> tasks;
+    std::vector<Task> tasks;
     auto policy = std::make_shared<DeterministicPolicy>();
 
     for (const auto &st : scenario_tasks) {
-      auto task = std::make_shared<Task>(st.timestamp, st.size_bytes,
-                                         st.density_cycles_bytes, st.deadline);
-      tasks.push_back(task);
-      policy->add_decision(task->get_id(), st.decision);
+      tasks.emplace_back(st.timestamp, st.size_bytes, st.density_cycles_bytes,
+                         st.deadline);
+      policy->add_decision(tasks.back().get_id(), st.decision);
     }
 
     return {tasks, policy};
@@ -5,11 +5,29 @@ CONFIG -= qt
 
 INCLUDEPATH += $$PWD
 
+# Compiles the engine tracer (core/Tracer.h, --trace=FILE) out entirely
+# DEFINES += TANK_NO_TRACE
+
+# Compiles trace lines below the level out of the binary (DEBUG, INFO, WARN,
+# ERROR or OFF; default DEBUG, with setDebug()/setTrace() deciding at run time)
+# DEFINES += TANK_LOG_LEVEL=WARN
+
 SOURCES += \
     main.cpp \
     core/Simulator.cpp \
+    core/EventQueue.cpp \
+    core/EventType.cpp \
+    core/CalendarQueue.cpp \
+    core/RadixQueue.cpp \
+    core/TimingWheel.cpp \
+    core/Snapshot.cpp \
+    core/EngineStats.cpp \
+    core/Tracer.cpp \
+    core/ParallelSimulator.cpp \
+    core/SimContext.cpp \
     events/TaskGenerationEvent.cpp \
     model/CPU.cpp \
+    model/EventHandlers.cpp \
     model/FirstRemotePolicy.cpp \
     model/IntelligentPolicy.cpp \
     model/Model.cpp \
@@ -24,22 +42,41 @@ HEADERS += \
     events/SpecifiedTasksEvent.h \
     logger.h \
     metric.h \
+    metric_columns.h \
+    metric_stats.h \
     core/Event.h \
     core/Simulator.h \
+    core/EventPool.h \
+    core/EventQueue.h \
+    core/EventType.h \
+    core/RingQueue.h \
+    core/RunState.h \
+    core/BinaryHeapQueue.h \
+    core/CalendarQueue.h \
+    core/RadixQueue.h \
+    core/TimingWheel.h \
+    core/Snapshot.h \
+    core/EngineStats.h \
+    core/Tracer.h \
+    core/ParallelSimulator.h \
+    core/SimContext.h \
     core/EnergyManager.h \
-    events/CPUEvent.h \
-    events/DecisionEvent.h \
     events/TaskGenerationEvent.h \
+    events/OffloadArrivalEvent.h \
     model/CPU.h \
-    model/EventType.h \
     model/FirstRemotePolicy.h \
     model/IntelligentPolicy.h \
+    model/MetricNames.h \
     model/Model.h \
     model/OffPolicy.h \
+    model/Policies.h \
     model/RSU.h \
     model/RandomPolicy.h \
     model/Task.h \
+    model/TaskStore.h \
     model/Vehicle.h \
     model/Battery.h \
     utils/IdManager.h \
-    utils/Rng.h
+    utils/Philox.h \
+    utils/Rng.h \
+    utils/Workload.h
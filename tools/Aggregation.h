@@ -0,0 +1,311 @@
+#ifndef AGGREGATION_H
+#define AGGREGATION_H
+
+// Per-run statistics and their aggregation into results/aggregated_*.csv,
+// shared by log_aggregator (from metric CSVs) and campaign (in process)
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../metric_stats.h"
+
+// Time -> (sum, count), one bin per TIME_BIN_SIZE seconds
+using TimeSeries = std::map<int, std::pair<double, int>>;
+
+const int TIME_BIN_SIZE = 1;
+
+// Counters of one run, fed record by record
+struct SimulationStats {
+  std::string policy;
+  std::string filename;
+
+  // Contadores
+  long total_tasks = 0;
+  long successes = 0;
+  long failures = 0;  // Overflow ou outros
+  long offload_local = 0;
+  long offload_remote = 0;
+
+  // Energia
+  double energy_cpu = 0.0;
+  double energy_tx = 0.0;
+
+  // Latência: média exata, percentis pelo sketch (erro relativo de 1%)
+  RunningStats latency;
+  QuantileSketch latency_quantiles;
+  RunningStats transfer_time;
+
+  // Time Series (Binning)
+  TimeSeries queue_series;       // Decision queue
+  TimeSeries queue_proc_series;  // Processing queue
+  TimeSeries battery_series;
+  std::map<int, int> failures_series;  // Time -> count
+
+  void add(double time, const std::string &metric, double value,
+           const std::string &tag) {
+    int bin = static_cast<int>(time) / TIME_BIN_SIZE;
+    if (metric == "TaskSuccess") {
+      // Value pode ser 1 ou 0
+      if (value > 0.5) successes++;
+      total_tasks++;
+    } else if (metric == "FullQueueError") {
+      failures++;
+      failures_series[bin]++;
+      total_tasks++;  // Conta como task tentada
+    } else if (metric == "TaskLatency") {
+      latency.add(value);
+      latency_quantiles.add(value);
+    } else if (metric == "TransferTime") {
+      transfer_time.add(value);
+    } else if (metric == "EnergyConsumption") {
+      if (tag.find("CpuOnly") != std::string::npos)
+        energy_cpu += value;
+      else if (tag.find("TxOnly") != std::string::npos)
+        energy_tx += value;
+    } else if (metric == "QueueSize_Decision") {
+      queue_series[bin].first += value;
+      queue_series[bin].second++;
+    } else if (metric == "QueueSize_Processing") {
+      queue_proc_series[bin].first += value;
+      queue_proc_series[bin].second++;
+    } else if (metric == "BatteryRemaining") {
+      battery_series[bin].first += value;
+      battery_series[bin].second++;
+    } else if (metric == "OffloadingType") {
+      if (value == 1.0)
+        offload_remote++;
+      else
+        offload_local++;
+    }
+  }
+};
+
+// One row of aggregated_summary.csv plus the series of its run
+struct RunSummary {
+  std::string policy;
+  std::string filename;
+  std::string params;  // parameter grid point, empty outside campaigns
+  int seed = -1;       // pairs runs of different policies (campaign)
+  double success_rate = 0.0;
+  double energy_cpu = 0.0;
+  double energy_tx = 0.0;
+  double latency_avg = 0.0;
+  double latency_p50 = 0.0;
+  double latency_p95 = 0.0;
+  long failures = 0;
+  long offload_local = 0;
+  long offload_remote = 0;
+  double transfer_avg = 0.0;
+  TimeSeries queue_series;
+  TimeSeries queue_proc_series;
+  TimeSeries battery_series;
+};
+
+inline RunSummary summarize(SimulationStats &stats) {
+  RunSummary s;
+  s.policy = stats.policy;
+  s.filename = stats.filename;
+  s.success_rate = stats.total_tasks > 0
+                       ? (double)stats.successes / stats.total_tasks
+                       : 0.0;
+  s.energy_cpu = stats.energy_cpu;
+  s.energy_tx = stats.energy_tx;
+
+  // Latencia
+  s.latency_avg = stats.latency.mean();
+  s.latency_p50 = stats.latency_quantiles.quantile(0.50);
+  s.latency_p95 = stats.latency_quantiles.quantile(0.95);
+  s.transfer_avg = stats.transfer_time.mean();
+
+  s.failures = stats.failures;
+  s.offload_local = stats.offload_local;
+  s.offload_remote = stats.offload_remote;
+  s.queue_series = std::move(stats.queue_series);
+  s.queue_proc_series = std::move(stats.queue_proc_series);
+  s.battery_series = std::move(stats.battery_series);
+  return s;
+}
+
+// Summary rows in insertion order and series averaged per policy; a Params
+// column is added when any run belongs to a parameter grid
+class Aggregate {
+  // (Policy, Params) -> TimeBin -> {SumValue, Count} (média global)
+  using Key = std::pair<std::string, std::string>;
+
+  std::vector<RunSummary> rows;
+  std::map<Key, TimeSeries> queue_agg;
+  std::map<Key, TimeSeries> queue_proc_agg;
+  std::map<Key, TimeSeries> batt_agg;
+  bool has_params = false;
+
+  static void merge(TimeSeries &into, const TimeSeries &series) {
+    for (auto const &[bin, val] : series) {
+      into[bin].first += val.first;    // Soma das somas
+      into[bin].second += val.second;  // Soma dos counts
+    }
+  }
+
+  // Sample variance
+  static double variance(const std::vector<double> &x) {
+    if (x.size() < 2) return 0.0;
+    double m = std::accumulate(x.begin(), x.end(), 0.0) / x.size();
+    double ss = 0.0;
+    for (double v : x) ss += (v - m) * (v - m);
+    return ss / (x.size() - 1);
+  }
+
+  static double mean(const TimeSeries &series, int bin) {
+    auto it = series.find(bin);
+    if (it == series.end() || it->second.second == 0) return 0.0;
+    return it->second.first / it->second.second;
+  }
+
+ public:
+  size_t size() const { return rows.size(); }
+
+  void add(const RunSummary &run) {
+    Key key{run.policy, run.params};
+    merge(queue_agg[key], run.queue_series);
+    merge(queue_proc_agg[key], run.queue_proc_series);
+    merge(batt_agg[key], run.battery_series);
+    has_params = has_params || !run.params.empty();
+    rows.push_back(run);
+    // Series already merged; keep rows light
+    rows.back().queue_series.clear();
+    rows.back().queue_proc_series.clear();
+    rows.back().battery_series.clear();
+  }
+
+  void write_summary(const std::string &path) const {
+    std::ofstream out(path);
+    out << "Policy,Filename,SuccessRate,TotalEnergyCPU,TotalEnergyTx,"
+           "AvgLatency,P50Latency,P95Latency,Failures,OffloadLocal,"
+           "OffloadRemote,AvgTransferTime"
+        << (has_params ? ",Params" : "") << std::endl;
+    for (const auto &r : rows) {
+      out << r.policy << "," << r.filename << "," << r.success_rate << ","
+          << r.energy_cpu << "," << r.energy_tx << "," << r.latency_avg << ","
+          << r.latency_p50 << "," << r.latency_p95 << "," << r.failures << ","
+          << r.offload_local << "," << r.offload_remote << ","
+          << r.transfer_avg;
+      if (has_params) out << "," << r.params;
+      out << std::endl;
+    }
+  }
+
+  /**
+   * @brief Paired (common random numbers) comparison of every policy
+   * against `baseline`, per grid point and metric
+   *
+   * Runs of two policies with the same seed see the same workload, so the
+   * variance of their difference is below the var(A) + var(B) of
+   * independent runs. Reduction = (var(A) + var(B)) / var(A - B) is the
+   * factor by which pairing cuts the runs needed for a given confidence
+   * interval (95% half-widths, normal approximation). Writes one CSV row
+   * per comparison and prints a table to `log`.
+   */
+  void write_variance_reduction(const std::string &path,
+                                const std::string &baseline,
+                                std::ostream &log) const {
+    struct Metric {
+      const char *name;
+      double (*of)(const RunSummary &);
+    };
+    static const Metric metrics[] = {
+        {"SuccessRate", [](const RunSummary &r) { return r.success_rate; }},
+        {"AvgLatency", [](const RunSummary &r) { return r.latency_avg; }},
+        {"TotalEnergy",
+         [](const RunSummary &r) { return r.energy_cpu + r.energy_tx; }},
+    };
+
+    // (Params, Policy) -> seed -> run
+    std::map<Key, std::map<int, const RunSummary *>> runs;
+    for (const auto &r : rows) {
+      if (r.seed >= 0) runs[{r.params, r.policy}][r.seed] = &r;
+    }
+
+    std::ios format(nullptr);
+    format.copyfmt(log);
+    log << std::defaultfloat << std::setprecision(4);
+
+    std::ofstream out(path);
+    out << "Params,Policy,Baseline,Metric,Pairs,MeanDiff,VarIndependent,"
+           "VarPaired,Reduction,CI95Paired,CI95Independent"
+        << std::endl;
+    log << std::left << std::setw(14) << "Policy" << std::setw(13)
+        << "Metric" << std::right << std::setw(7) << "Pairs" << std::setw(13)
+        << "MeanDiff" << std::setw(13) << "CI95 paired" << std::setw(13)
+        << "CI95 indep" << std::setw(11) << "Reduction" << std::endl;
+
+    for (const auto &[key, by_seed] : runs) {
+      const auto &[params, policy] = key;
+      auto base = runs.find({params, baseline});
+      if (policy == baseline || base == runs.end()) continue;
+      for (const Metric &m : metrics) {
+        std::vector<double> a, b;
+        for (const auto &[seed, run] : by_seed) {
+          auto other = base->second.find(seed);
+          if (other == base->second.end()) continue;
+          a.push_back(m.of(*run));
+          b.push_back(m.of(*other->second));
+        }
+        size_t n = a.size();
+        if (n < 2) continue;
+        std::vector<double> d(n);
+        for (size_t i = 0; i < n; ++i) d[i] = a[i] - b[i];
+        double var_indep = variance(a) + variance(b);
+        double var_paired = variance(d);
+        double reduction = var_paired > 0.0
+                               ? var_indep / var_paired
+                               : std::numeric_limits<double>::infinity();
+        double ci_paired = 1.96 * std::sqrt(var_paired / n);
+        double ci_indep = 1.96 * std::sqrt(var_indep / n);
+        double mean_diff = std::accumulate(d.begin(), d.end(), 0.0) / n;
+
+        out << params << "," << policy << "," << baseline << "," << m.name
+            << "," << n << "," << mean_diff << "," << var_indep << ","
+            << var_paired << "," << reduction << "," << ci_paired << ","
+            << ci_indep << std::endl;
+        log << std::left << std::setw(14) << policy << std::setw(13)
+            << m.name << std::right << std::setw(7) << n << std::setw(13)
+            << mean_diff << std::setw(13) << ci_paired << std::setw(13)
+            << ci_indep << std::setw(11) << reduction
+            << (params.empty() ? "" : "  " + params) << std::endl;
+      }
+    }
+    log.copyfmt(format);
+  }
+
+  void write_timeseries(const std::string &path) const {
+    std::ofstream out(path);
+    out << "Policy,Time,AvgQueueSize,AvgQueueProc,AvgBattery"
+        << (has_params ? ",Params" : "") << std::endl;
+    for (auto const &[key, bin_map] : queue_agg) {
+      if (bin_map.empty()) continue;
+      static const TimeSeries none;
+      auto proc = queue_proc_agg.find(key);
+      auto batt = batt_agg.find(key);
+      // Range de tempo da fila de decisão
+      int max_time = bin_map.rbegin()->first;
+      for (int t = 0; t <= max_time; t++) {
+        out << key.first << "," << t << "," << mean(bin_map, t) << ","
+            << mean(proc != queue_proc_agg.end() ? proc->second : none, t)
+            << ","
+            << mean(batt != batt_agg.end() ? batt->second : none, t);
+        if (has_params) out << "," << key.second;
+        out << std::endl;
+      }
+    }
+  }
+};
+
+#endif  // AGGREGATION_H
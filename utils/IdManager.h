@@ -2,9 +2,49 @@
 #define IDMANAGER_H
 
 struct IdManager {
-  static int next_id() {
+  // Id sequence owned by one SimContext
+  struct Stream {
+    int next = 0;
+  };
+
+  static int &counter() {
     static int id = 0;
-    return ++id;
+    return id;
+  }
+
+  static Stream *&bound() {
+    static thread_local Stream *stream = nullptr;
+    return stream;
+  }
+
+  // Route next_id() of the calling thread to a stream (or back to the
+  // process-wide counter with nullptr); returns the previous binding
+  static Stream *bind(Stream *stream) {
+    Stream *previous = bound();
+    bound() = stream;
+    return previous;
+  }
+
+  // Id the next call to next_id() returns
+  static int peek() {
+    if (Stream *s = bound()) return s->next;
+    return counter() + 1;
+  }
+
+  // Continues the calling thread's sequence at `next`
+  static void resume_at(int next) {
+    if (Stream *s = bound()) {
+      s->next = next;
+    } else {
+      counter() = next - 1;
+    }
+  }
+
+  static int next_id() {
+    if (Stream *s = bound()) {
+      return s->next++;
+    }
+    return ++counter();
   }
 };
 
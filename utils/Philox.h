@@ -0,0 +1,218 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PHILOX_X86 1
+#endif
+
+/**
+ * @brief Philox4x32-10 counter-based generator (Salmon et al., SC'11)
+ *
+ * Output i of a stream is a pure function of (key, stream, i): block i / 4
+ * of the keyed bijection applied to the counter {block, stream}, word i % 4.
+ * Any position can be sampled directly (at()), discard() is O(1) and the
+ * whole state is a few words, so replicas and partitions split streams
+ * without coordination and cheaply save / restore them.
+ *
+ * Satisfies UniformRandomBitGenerator. generate() fills arrays block-wise
+ * with AVX2 (8 blocks per step) when the CPU supports it and a scalar loop
+ * otherwise; both produce the same words.
+ */
+class Philox4x32 {
+ public:
+  using result_type = uint32_t;
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  explicit Philox4x32(uint32_t key0 = 0, uint32_t key1 = 0,
+                      uint32_t stream_ = 0) {
+    seed(key0, key1, stream_);
+  }
+
+  void seed(uint32_t key0, uint32_t key1 = 0, uint32_t stream_ = 0) {
+    key[0] = key0;
+    key[1] = key1;
+    stream = stream_;
+    position = 0;
+    cached = NONE;
+  }
+
+  result_type operator()() {
+    uint64_t b = position >> 2;
+    if (b != cached) {
+      block(b, cache);
+      cached = b;
+    }
+    return cache[position++ & 3];
+  }
+
+  // Output `index` of the stream, independent of the current position
+  result_type at(uint64_t index) const {
+    uint32_t out[4];
+    block(index >> 2, out);
+    return out[index & 3];
+  }
+
+  void discard(uint64_t n) { position += n; }
+  uint64_t tell() const { return position; }
+
+  // Next n outputs, as n calls to operator()
+  void generate(uint32_t *out, size_t n) {
+    while (n > 0 && (position & 3) != 0) {
+      *out++ = (*this)();
+      --n;
+    }
+    size_t blocks = n / 4;
+    generate_blocks(position >> 2, blocks, out, simd());
+    position += 4 * uint64_t(blocks);
+    out += 4 * blocks;
+    n -= 4 * blocks;
+    while (n-- > 0) *out++ = (*this)();
+  }
+
+  // Blocks [first, first + count) as 4 words each; AVX2 if requested and
+  // supported
+  void generate_blocks(uint64_t first, size_t count, uint32_t *out,
+                       bool use_simd) const {
+    size_t done = 0;
+#ifdef PHILOX_X86
+    if (use_simd && avx2_supported()) {
+      done = count - count % 8;
+      for (size_t i = 0; i < done; i += 8) {
+        blocks8_avx2(first + i, out + 4 * i);
+      }
+    }
+#endif
+    for (size_t i = done; i < count; ++i) block(first + i, out + 4 * i);
+  }
+
+  static bool avx2_supported() {
+#ifdef PHILOX_X86
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+  // Process-wide switch for the vectorized path (benchmarks, verification)
+  static bool &simd() {
+    static bool enabled = true;
+    return enabled;
+  }
+
+  // Same key and stream, whatever the positions
+  bool same_sequence(const Philox4x32 &o) const {
+    return key[0] == o.key[0] && key[1] == o.key[1] && stream == o.stream;
+  }
+
+  bool operator==(const Philox4x32 &o) const {
+    return same_sequence(o) && position == o.position;
+  }
+  bool operator!=(const Philox4x32 &o) const { return !(*this == o); }
+
+ private:
+  static constexpr uint32_t M0 = 0xD2511F53;
+  static constexpr uint32_t M1 = 0xCD9E8D57;
+  static constexpr uint32_t W0 = 0x9E3779B9;
+  static constexpr uint32_t W1 = 0xBB67AE85;
+  static constexpr int ROUNDS = 10;
+  static constexpr uint64_t NONE = std::numeric_limits<uint64_t>::max();
+
+  uint32_t key[2];
+  uint32_t stream;
+  uint64_t position;  // index of the next output
+  uint64_t cached;    // block held in cache
+  uint32_t cache[4];
+
+  void block(uint64_t b, uint32_t *out) const {
+    uint32_t x0 = static_cast<uint32_t>(b);
+    uint32_t x1 = static_cast<uint32_t>(b >> 32);
+    uint32_t x2 = stream;
+    uint32_t x3 = 0;
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+    for (int r = 0; r < ROUNDS; ++r) {
+      uint64_t p0 = uint64_t(M0) * x0;
+      uint64_t p1 = uint64_t(M1) * x2;
+      uint32_t y0 = static_cast<uint32_t>(p1 >> 32) ^ x1 ^ k0;
+      uint32_t y2 = static_cast<uint32_t>(p0 >> 32) ^ x3 ^ k1;
+      x1 = static_cast<uint32_t>(p1);
+      x3 = static_cast<uint32_t>(p0);
+      x0 = y0;
+      x2 = y2;
+      k0 += W0;
+      k1 += W1;
+    }
+    out[0] = x0;
+    out[1] = x1;
+    out[2] = x2;
+    out[3] = x3;
+  }
+
+#ifdef PHILOX_X86
+  // 32x32 -> 64 products of 8 lanes: low halves returned, high in `hi`
+  __attribute__((target("avx2"))) static __m256i mulhilo(__m256i a,
+                                                         __m256i m,
+                                                         __m256i &hi) {
+    __m256i even = _mm256_mul_epu32(a, m);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    return _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+  }
+
+  // Blocks first .. first + 7, one per lane
+  __attribute__((target("avx2"))) void blocks8_avx2(uint64_t first,
+                                                    uint32_t *out) const {
+    alignas(32) uint32_t lo[8], hi_words[8];
+    for (int i = 0; i < 8; ++i) {
+      lo[i] = static_cast<uint32_t>(first + i);
+      hi_words[i] = static_cast<uint32_t>((first + i) >> 32);
+    }
+    __m256i x0 = _mm256_load_si256(reinterpret_cast<const __m256i *>(lo));
+    __m256i x1 =
+        _mm256_load_si256(reinterpret_cast<const __m256i *>(hi_words));
+    __m256i x2 = _mm256_set1_epi32(static_cast<int>(stream));
+    __m256i x3 = _mm256_setzero_si256();
+    const __m256i m0 = _mm256_set1_epi32(static_cast<int>(M0));
+    const __m256i m1 = _mm256_set1_epi32(static_cast<int>(M1));
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+    for (int r = 0; r < ROUNDS; ++r) {
+      __m256i hi0, hi1;
+      __m256i lo0 = mulhilo(x0, m0, hi0);
+      __m256i lo1 = mulhilo(x2, m1, hi1);
+      x0 = _mm256_xor_si256(_mm256_xor_si256(hi1, x1),
+                            _mm256_set1_epi32(static_cast<int>(k0)));
+      x2 = _mm256_xor_si256(_mm256_xor_si256(hi0, x3),
+                            _mm256_set1_epi32(static_cast<int>(k1)));
+      x1 = lo1;
+      x3 = lo0;
+      k0 += W0;
+      k1 += W1;
+    }
+    // Lanes hold word w of 8 blocks; interleave to block order
+    alignas(32) uint32_t w[4][8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(w[0]), x0);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(w[1]), x1);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(w[2]), x2);
+    _mm256_store_si256(reinterpret_cast<__m256i *>(w[3]), x3);
+    for (int i = 0; i < 8; ++i) {
+      out[4 * i] = w[0][i];
+      out[4 * i + 1] = w[1][i];
+      out[4 * i + 2] = w[2][i];
+      out[4 * i + 3] = w[3][i];
+    }
+  }
+#endif
+};
+
+#endif  // PHILOX_H
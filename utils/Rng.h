@@ -1,40 +1,197 @@
 #ifndef RNG_H
 #define RNG_H
 
-#include <random>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <vector>
 
+#include "Philox.h"
+
 // Forward declaration - ChaosManager is now in core/ChaosManager.h
 class ChaosManager;
 
 struct Rng {
   static constexpr int seed = 1978;
-  static std::mt19937 &engine() {
-    static std::mt19937 e{seed};
-    return e;
+
+  // Purpose of a draw. Each purpose has its own engine, so e.g. the
+  // workload (arrivals, task attributes) is the same for every policy run
+  // with a given seed (common random numbers), whatever the policy draws.
+  enum Stream {
+    ARRIVALS,  // task inter-arrival times
+    TASK,      // task size, density and deadline
+    DECISION,  // decision (policy compute) time
+    POLICY,    // randomized policy choices
+    HARDWARE,  // per-node hardware (RSU CPU frequency)
+    NETWORK,   // chaos bandwidth drops, keyed by task id
+    STREAM_COUNT
+  };
+
+  using Engine = Philox4x32;
+
+  // Engines of one simulation, one per Stream. Counter-based: a few words
+  // each, cheap to copy for state saving and to jump ahead (discard)
+  struct Streams {
+    std::array<Engine, STREAM_COUNT> engines;
+    uint32_t key = Rng::seed;  // run seed
+
+    explicit Streams(uint32_t s = Rng::seed) { this->seed(s); }
+
+    // Stream k is keyed (s, salt) on counter subsequence k; salt 0 is the
+    // run-wide set, salt e > 0 the set of entity e (derive())
+    void seed(uint32_t s, uint32_t salt = 0) {
+      key = s;
+      for (uint32_t k = 0; k < STREAM_COUNT; ++k) engines[k].seed(s, salt, k);
+    }
+
+    // Streams of entity `entity` under the same run seed: the same draws
+    // whichever order entities act in and however a run is partitioned
+    Streams derive(uint32_t entity) const {
+      Streams s(key);
+      s.seed(key, entity);
+      return s;
+    }
+
+    Engine &operator[](Stream k) { return engines[k]; }
+  };
+
+  static Streams *&bound_streams() {
+    static thread_local Streams *s = nullptr;
+    return s;
   }
 
-  static double exponential(double lambda) {
-    std::exponential_distribution<double> d(lambda);
-    return d(engine());
+  // Route streams() of the calling thread to an entity- or context-owned
+  // set (or back to the process-wide one with nullptr); returns the
+  // previous binding
+  static Streams *bind(Streams *s) {
+    Streams *previous = bound_streams();
+    bound_streams() = s;
+    return previous;
   }
 
-  static double normal(double mu, double sigma) {
-    std::normal_distribution<double> d(mu, sigma);
-    return d(engine());
+  static Streams &streams() {
+    static Streams global;
+    Streams *b = bound_streams();
+    return b ? *b : global;
   }
 
-  static double uniform(double a, double b) {
-    std::uniform_real_distribution<double> d(a, b);
-    return d(engine());
+  static Engine &engine(Stream k) { return streams()[k]; }
+
+  // [0, 1) with 52 random bits taken from two outputs (hi, lo)
+  static double unit(uint32_t hi, uint32_t lo) {
+    uint64_t bits = 0x3FF0000000000000ull | (uint64_t(hi) << 20) | (lo >> 12);
+    double d;
+    std::memcpy(&d, &bits, sizeof d);
+    return d - 1.0;
+  }
+
+  static double unit(Engine &e) {
+    uint32_t hi = e();
+    return unit(hi, e());
+  }
+
+  // Unit `index` of stream k, apart from its position: keyed by e.g. a task
+  // id, it is the same whichever thread draws it and in whatever order
+  static double unit_at(Stream k, uint64_t index) {
+    const Engine &e = engine(k);
+    return unit(e.at(2 * index), e.at(2 * index + 1));
+  }
+
+  // Transforms of unit variates, shared by the single and batched draws
+  static double to_uniform(double u, double a, double b) {
+    return a + (b - a) * u;
+  }
+
+  // Exp(1); divide by lambda for Exp(lambda)
+  static double to_exponential(double u) { return -std::log1p(-u); }
+
+  // Box-Muller, one N(0, 1) variate per pair of units; stateless, unlike
+  // std::normal_distribution which caches the second one
+  static double to_normal(double u1, double u2) {
+    static constexpr double two_pi = 6.283185307179586476925;
+    return std::sqrt(-2.0 * std::log1p(-u1)) * std::cos(two_pi * u2);
   }
 
-  static int uniform_int(int a, int b) {
-    std::uniform_int_distribution<int> d(a, b);
-    return d(engine());
+  static double exponential(Stream k, double lambda) {
+    return to_exponential(unit(engine(k))) / lambda;
   }
 
+  static double normal(Stream k, double mu, double sigma) {
+    Engine &e = engine(k);
+    double u1 = unit(e);
+    return mu + sigma * to_normal(u1, unit(e));
+  }
+
+  static double uniform(Stream k, double a, double b) {
+    return to_uniform(unit(engine(k)), a, b);
+  }
+
+  // Unbiased integer in [a, b] (Lemire's multiply-and-reject)
+  static int uniform_int(Stream k, int a, int b) {
+    Engine &e = engine(k);
+    uint64_t range = uint64_t(int64_t(b) - int64_t(a)) + 1;
+    if (range > Engine::max()) return static_cast<int>(int64_t(a) + e());
+    uint64_t m = uint64_t(e()) * range;
+    if (static_cast<uint32_t>(m) < range) {
+      uint32_t threshold =
+          static_cast<uint32_t>((0x100000000ull - range) % range);
+      while (static_cast<uint32_t>(m) < threshold) m = uint64_t(e()) * range;
+    }
+    return static_cast<int>(int64_t(a) + int64_t(m >> 32));
+  }
+
+  /**
+   * @name Batched draws
+   * Fill out[0 .. n) with exactly the values n calls of the single draw
+   * would return, advancing the stream the same way. The raw outputs are
+   * generated a block at a time (AVX2 where available); transforms stay
+   * scalar so results do not depend on the instruction set.
+   */
+  ///@{
+  static void fill_uniform(Stream k, double *out, size_t n, double a = 0.0,
+                           double b = 1.0) {
+    fill_units(engine(k), out, n);
+    for (size_t i = 0; i < n; ++i) out[i] = to_uniform(out[i], a, b);
+  }
+
+  static void fill_exponential(Stream k, double *out, size_t n,
+                               double lambda) {
+    fill_units(engine(k), out, n);
+    for (size_t i = 0; i < n; ++i) out[i] = to_exponential(out[i]) / lambda;
+  }
+
+  static void fill_normal(Stream k, double *out, size_t n, double mu,
+                          double sigma) {
+    Engine &e = engine(k);
+    double units[2 * BATCH];
+    while (n > 0) {
+      size_t m = std::min(n, BATCH);
+      fill_units(e, units, 2 * m);
+      for (size_t i = 0; i < m; ++i) {
+        out[i] = mu + sigma * to_normal(units[2 * i], units[2 * i + 1]);
+      }
+      out += m;
+      n -= m;
+    }
+  }
+
+  // n units from 2n consecutive outputs of e
+  static void fill_units(Engine &e, double *out, size_t n) {
+    uint32_t raw[2 * BATCH];
+    while (n > 0) {
+      size_t m = std::min(n, BATCH);
+      e.generate(raw, 2 * m);
+      for (size_t i = 0; i < m; ++i) out[i] = unit(raw[2 * i], raw[2 * i + 1]);
+      out += m;
+      n -= m;
+    }
+  }
+  ///@}
+
   /**
    * @brief Apply drift to a base value using explicit drift state
    *
@@ -52,14 +209,16 @@ struct Rng {
   }
 
   template <typename T>
-  static T sample(const std::vector<T> &vec) {
+  static T sample(Stream k, const std::vector<T> &vec) {
     if (vec.empty()) {
       throw std::runtime_error(
           "Rng::sample: Attempted to sample from an empty vector.");
     }
-    std::uniform_int_distribution<size_t> d(0, vec.size() - 1);
-    return vec[d(engine())];
+    return vec[uniform_int(k, 0, static_cast<int>(vec.size()) - 1)];
   }
+
+ private:
+  static constexpr size_t BATCH = 256;
 };
 
 #endif  // RNG_H
@@ -0,0 +1,158 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed thread pool for coarse independent jobs (simulation replicas)
+ *
+ * Every worker owns a deque: it runs its own jobs newest first and, when
+ * empty, steals the oldest job of another worker, so one long job never
+ * leaves the other threads idle behind it. Jobs submitted from outside are
+ * dealt round-robin; jobs submitted by a running job go to its worker.
+ */
+class WorkStealingPool {
+ public:
+  using Job = std::function<void()>;
+
+  explicit WorkStealingPool(
+      size_t threads = std::thread::hardware_concurrency()) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) {
+      queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+      workers.emplace_back([this, i] { worker_loop(i); });
+    }
+  }
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stopping = true;
+    }
+    work_cv.notify_all();
+    for (auto &w : workers) w.join();
+  }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  size_t size() const { return workers.size(); }
+
+  void submit(Job job) {
+    size_t index = current() == this ? current_index()
+                                     : next_queue++ % queues.size();
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      ++pending;
+      ++queued;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queues[index]->mtx);
+      queues[index]->jobs.push_back(std::move(job));
+    }
+    work_cv.notify_one();
+  }
+
+  // Blocks until every submitted job finished; rethrows the first exception
+  void wait() {
+    std::unique_lock<std::mutex> lock(mtx);
+    done_cv.wait(lock, [this] { return pending == 0; });
+    if (error) {
+      std::exception_ptr e = error;
+      error = nullptr;
+      std::rethrow_exception(e);
+    }
+  }
+
+  uint64_t steals() const { return stolen.load(); }
+
+ private:
+  struct Queue {
+    std::mutex mtx;
+    std::deque<Job> jobs;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::atomic<size_t> next_queue{0};
+  std::atomic<uint64_t> stolen{0};
+
+  std::mutex mtx;
+  std::condition_variable work_cv;
+  std::condition_variable done_cv;
+  size_t pending = 0;  // submitted and not finished
+  size_t queued = 0;   // submitted and not started
+  bool stopping = false;
+  std::exception_ptr error;
+
+  static WorkStealingPool *&current() {
+    static thread_local WorkStealingPool *pool = nullptr;
+    return pool;
+  }
+
+  static size_t &current_index() {
+    static thread_local size_t index = 0;
+    return index;
+  }
+
+  bool take(size_t self, Job &job) {
+    {
+      Queue &own = *queues[self];
+      std::lock_guard<std::mutex> lock(own.mtx);
+      if (!own.jobs.empty()) {
+        job = std::move(own.jobs.back());
+        own.jobs.pop_back();
+        return true;
+      }
+    }
+    for (size_t k = 1; k < queues.size(); ++k) {
+      Queue &victim = *queues[(self + k) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mtx);
+      if (!victim.jobs.empty()) {
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        ++stolen;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void worker_loop(size_t self) {
+    current() = this;
+    current_index() = self;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        work_cv.wait(lock, [this] { return stopping || queued > 0; });
+        if (queued == 0) return;  // stopping and drained
+        --queued;
+      }
+      // A job is reserved for this worker: some deque holds it
+      Job job;
+      while (!take(self, job)) std::this_thread::yield();
+      try {
+        job();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!error) error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mtx);
+      if (--pending == 0) done_cv.notify_all();
+    }
+  }
+};
+
+#endif  // WORKSTEALINGPOOL_H
@@ -0,0 +1,127 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Rng.h"
+
+/**
+ * @brief Task variates pre-drawn in blocks, struct-of-arrays
+ *
+ * Every generated task takes four units from the TASK stream (size,
+ * density pair, deadline) and one from ARRIVALS (inter-arrival gap). Both
+ * streams are counter-based, so the variates of the next BLOCK tasks are a
+ * pure function of the current stream positions: next() fills the columns
+ * a block ahead with the batched draws, does the transcendental transforms
+ * there, and then only advances the live engines per task. A block is
+ * reused while the engines are where it expects them and rebuilt
+ * otherwise (first use, another context or entity, optimistic
+ * rollback), so values equal the per-call draws in every case.
+ *
+ * Columns hold parameter-free variates; Task and TaskGenerationEvent apply
+ * the configured ranges and the live chaos drift when a task is consumed.
+ */
+class Workload {
+ public:
+  static constexpr size_t BLOCK = 512;          // tasks per block
+  static constexpr size_t ENTITY_BLOCK = 64;    // ... per entity (Model)
+  static constexpr uint64_t TASK_WORDS = 8;     // TASK outputs per task
+  static constexpr uint64_t ARRIVAL_WORDS = 2;  // ARRIVALS outputs per task
+
+  // Variates of one task
+  struct Draws {
+    double size;      // U[0, 1), scaled to the size range
+    double density;   // N(0, 1)
+    double deadline;  // U[0, 1), scaled to the deadline range
+    double gap;       // Exp(1), divided by the source rate
+  };
+
+  // Columns are allocated at the first draw
+  explicit Workload(size_t block_ = BLOCK) : block(block_) {}
+
+  // Next task on the bound streams; advances them as per-call draws would
+  Draws next() {
+    Rng::Engine &task = Rng::engine(Rng::TASK);
+    Rng::Engine &arrivals = Rng::engine(Rng::ARRIVALS);
+    size_t i = find(task, arrivals);
+    if (i == count) {
+      refill(task, arrivals);
+      i = 0;
+    }
+    task.discard(TASK_WORDS);
+    arrivals.discard(ARRIVAL_WORDS);
+    return {size[i], density[i], deadline[i], gap[i]};
+  }
+
+  static Workload &instance() {
+    static Workload global;
+    Workload *b = bound();
+    return b ? *b : global;
+  }
+
+  // Routes instance() of the calling thread to a context- or
+  // entity-owned workload (nullptr: the process-wide one); returns the
+  // previous binding
+  static Workload *bind(Workload *workload) {
+    Workload *previous = bound();
+    bound() = workload;
+    return previous;
+  }
+
+ private:
+  Rng::Engine task_base;  // engines at the start of the block
+  Rng::Engine arrival_base;
+  size_t block;      // tasks per block
+  size_t count = 0;  // tasks in the block
+  std::vector<double> size, density, deadline, gap;
+  std::vector<double> units;  // TASK units, 4 per task
+
+  static Workload *&bound() {
+    static thread_local Workload *workload = nullptr;
+    return workload;
+  }
+
+  // Index of the task the engines are at, count if outside the block
+  size_t find(const Rng::Engine &task, const Rng::Engine &arrivals) const {
+    if (count == 0 || !task.same_sequence(task_base) ||
+        !arrivals.same_sequence(arrival_base) ||
+        task.tell() < task_base.tell()) {
+      return count;
+    }
+    uint64_t offset = task.tell() - task_base.tell();
+    uint64_t i = offset / TASK_WORDS;
+    if (offset % TASK_WORDS != 0 || i >= count ||
+        arrivals.tell() != arrival_base.tell() + i * ARRIVAL_WORDS) {
+      return count;
+    }
+    return static_cast<size_t>(i);
+  }
+
+  void refill(const Rng::Engine &task, const Rng::Engine &arrivals) {
+    if (units.empty()) {
+      size.resize(block);
+      density.resize(block);
+      deadline.resize(block);
+      gap.resize(block);
+      units.resize(4 * block);
+    }
+    task_base = task;
+    arrival_base = arrivals;
+    Rng::Engine t = task;
+    Rng::Engine a = arrivals;
+    Rng::fill_units(t, units.data(), units.size());
+    Rng::fill_units(a, gap.data(), block);
+    for (size_t i = 0; i < block; ++i) {
+      const double *u = &units[4 * i];
+      size[i] = u[0];
+      density[i] = Rng::to_normal(u[1], u[2]);
+      deadline[i] = u[3];
+      gap[i] = Rng::to_exponential(gap[i]);
+    }
+    count = block;
+  }
+};
+
+#endif  // WORKLOAD_H